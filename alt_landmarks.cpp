@@ -0,0 +1,76 @@
+#include "alt_landmarks.h"
+#include "compressed_graph.h"
+#include "graph_search.h"
+
+// Farthest-first landmarks: after the Dijkstra search of every landmark, closest_landmark holds the distance from
+// every vortex to its closest landmark so far, and the vortex where it is largest is the next landmark. Missing
+// vortexes keep a zero distance so they are never chosen.
+alt_landmarks::alt_landmarks(const list_graph &graph, unsigned int landmark_number, unsigned long long seed)
+{
+	this->vortex_index_range = graph.get_vortex_index_range();
+	this->graph_version = graph.get_shortening_version();
+	if (landmark_number > (unsigned int)graph.vortex_number)
+		landmark_number = graph.vortex_number;
+	this->landmarks = new unsigned int[landmark_number > 0 ? landmark_number : 1];
+	this->landmark_distance = new unsigned int[(unsigned long long)this->vortex_index_range * (landmark_number > 0 ? landmark_number : 1)];
+	this->landmark_number = 0;
+	if (landmark_number == 0)
+		return;
+
+	unsigned int *closest_landmark = new unsigned int[this->vortex_index_range];
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+		closest_landmark[i] = graph.vortex_table[i] != nullptr ? UNREACHED : 0;
+
+	mt19937_64 generator(seed);
+	unsigned int next_landmark = generator() % this->vortex_index_range;
+	while (graph.vortex_table[next_landmark] == nullptr)
+		next_landmark = (next_landmark + 1) % this->vortex_index_range;
+
+	const compressed_graph *snapshot = graph.has_symmetric_storage() ? nullptr : &graph.get_query_snapshot(); // kept for the queries that follow
+	search_context context(this->vortex_index_range);
+	for (unsigned int k = 0; k < landmark_number; ++k)
+	{
+		this->landmarks[k] = next_landmark;
+		if (snapshot != nullptr)
+			dijkstra_all_distances(*snapshot, context, next_landmark);
+		else
+			dijkstra_all_distances(graph, context, next_landmark);
+		for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+		{
+			int distance = context.get_distance(i);
+			unsigned int stored = distance != numeric_limits<int>::max() ? (unsigned int)distance : UNREACHED;
+			this->landmark_distance[(unsigned long long)i * landmark_number + k] = stored;
+			if (stored < closest_landmark[i])
+				closest_landmark[i] = stored;
+		}
+
+		// there are more vortexes than landmarks, so a vortex that is not a landmark has a nonzero distance
+		next_landmark = 0;
+		for (unsigned int i = 1; i < this->vortex_index_range; ++i)
+			if (closest_landmark[i] > closest_landmark[next_landmark])
+				next_landmark = i;
+	}
+	this->landmark_number = landmark_number;
+	delete[] closest_landmark;
+}
+
+alt_landmarks::~alt_landmarks()
+{
+	delete[] this->landmarks;
+	delete[] this->landmark_distance;
+}
+
+unsigned int alt_landmarks::get_landmark_number() const
+{
+	return this->landmark_number;
+}
+
+unsigned int alt_landmarks::get_landmark(unsigned int landmark) const
+{
+	return this->landmarks[landmark];
+}
+
+bool alt_landmarks::is_valid_for(const list_graph &graph) const
+{
+	return graph.get_shortening_version() == this->graph_version;
+}
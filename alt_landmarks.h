@@ -0,0 +1,100 @@
+#ifndef ALT_LANDMARKS_H
+#define ALT_LANDMARKS_H
+
+/**
+ * @file alt_landmarks.h
+ * @brief Landmark distance tables giving the A* lower bounds of ALT (A*, landmarks, triangle inequality).
+ *
+ * @author Fernando Elena Benavente
+ *
+ * For a landmark L and any vortexes v and t, the triangle inequality gives d(v, t) >= |d(L, t) - d(L, v)|, so with the distances from a few landmarks to every vortex, the largest of those differences is a lower bound of the distance to the goal, which A* uses to steer the search towards it. The bound is consistent, so every vortex is still settled once.
+ *
+ * Landmarks are chosen farthest-first: the first one at random, and each next one is the vortex farthest from the landmarks already chosen (a vortex not reachable from any of them counts as the farthest, so every component gets a landmark). Each landmark costs one full Dijkstra search. The distances are stored as 32 bit integers, vortex-major (the distances of a vortex to all landmarks are contiguous), since a query reads every landmark of the vortexes it visits.
+ *
+ * The tables follow the graph as long as paths only get longer: a raised weight or a removed edge or vortex keeps every bound valid, just less tight. An added edge or a lowered weight can make a bound too big, so the tables record the list_graph::get_shortening_version() of the graph they were built on, and once it changes the queries ignore them (A* becomes Dijkstra's search) until they are built again.
+ */
+
+#include <limits>
+
+#include "graph.h"
+
+/**
+ * @class alt_landmarks
+ * @brief Distances from a set of landmarks to every vortex of a list_graph.
+ */
+class alt_landmarks
+{
+public:
+    static const unsigned int UNREACHED = std::numeric_limits<unsigned int>::max(); /**< Stored distance of a vortex the landmark does not reach. */
+
+    /**
+     * @brief Chooses the landmarks farthest-first and computes their distances to every vortex.
+     *
+     * @param graph The graph, not modified.
+     * @param landmark_number Number of landmarks, fewer are chosen if the graph has fewer vortexes.
+     * @param seed Seed of the first landmark choice.
+     */
+    alt_landmarks(const list_graph &graph, unsigned int landmark_number, unsigned long long seed);
+
+    /**
+     * @brief Destructor that frees the distance table.
+     */
+    ~alt_landmarks();
+
+    alt_landmarks(const alt_landmarks &) = delete;
+    alt_landmarks &operator=(const alt_landmarks &) = delete;
+
+    /**
+     * @brief Returns the number of landmarks.
+     */
+    unsigned int get_landmark_number() const;
+
+    /**
+     * @brief Returns the vortex index of a landmark.
+     *
+     * @param landmark The landmark, lower than get_landmark_number().
+     */
+    unsigned int get_landmark(unsigned int landmark) const;
+
+    /**
+     * @brief Returns true if no edge was added and no weight was lowered on the graph since the tables were built, so the bounds are valid.
+     *
+     * @param graph The graph the tables were built on.
+     */
+    bool is_valid_for(const list_graph &graph) const;
+
+    /**
+     * @brief Returns a lower bound of the distance between two vortexes, the largest landmark difference.
+     *
+     * @param vortex_index The index of a vortex.
+     * @param goal_vortex The index of the other vortex.
+     *
+     * @return The lower bound, 0 if a vortex was not in the graph when the tables were built.
+     */
+    int lower_bound(unsigned int vortex_index, unsigned int goal_vortex) const
+    {
+        if (vortex_index >= this->vortex_index_range || goal_vortex >= this->vortex_index_range)
+            return 0;
+        const unsigned int *vortex_row = this->landmark_distance + (unsigned long long)vortex_index * this->landmark_number;
+        const unsigned int *goal_row = this->landmark_distance + (unsigned long long)goal_vortex * this->landmark_number;
+        unsigned int bound = 0;
+        for (unsigned int k = 0; k < this->landmark_number; ++k)
+        {
+            if (vortex_row[k] == UNREACHED || goal_row[k] == UNREACHED)
+                continue; // the landmark is in another component, it gives no bound
+            unsigned int difference = vortex_row[k] > goal_row[k] ? vortex_row[k] - goal_row[k] : goal_row[k] - vortex_row[k];
+            if (difference > bound)
+                bound = difference;
+        }
+        return (int)bound;
+    }
+
+private:
+    unsigned int landmark_number;          /**< Number of landmarks, the row length of the table. */
+    unsigned int vortex_index_range;       /**< Index range of the graph when the tables were built, the number of rows. */
+    unsigned int *landmarks;               /**< Vortex index of every landmark. */
+    unsigned int *landmark_distance;       /**< Distance from landmark k to vortex v at v * landmark_number + k, or UNREACHED. */
+    unsigned long long graph_version;      /**< list_graph::get_shortening_version() when the tables were built. */
+};
+
+#endif
@@ -0,0 +1,298 @@
+#ifndef COMPACT_GRAPH_H
+#define COMPACT_GRAPH_H
+
+/**
+ * @file compact_graph.h
+ * @brief CSR snapshot with the widths of the vortex indexes, the weights and the row offsets picked at compile time.
+ *
+ * @author Fernando Elena Benavente
+ *
+ * A compressed_graph stores every half edge as a 32 bit neighbor index and a 32 bit weight, and every row offset in 64 bits, whatever the graph. Many graphs have fewer than 65536 vortexes and weights under 256, and their neighbors and weights fit in 3 bytes instead of 8. A compact_graph<VortexIndex, EdgeWeight, EdgeOffset> is the same CSR layout with those element types, so the memory and the cache traffic of a search follow the real width of the data: compact_graph<unsigned short, unsigned char> reads 3 bytes per half edge and 4 per vortex.
+ *
+ * It is built from a compressed_graph with build(), which returns nullptr when the graph does not fit the chosen types (too many vortexes for VortexIndex, a weight bigger than EdgeWeight, or too many half edges for EdgeOffset). The query methods are the ones of compressed_graph with the same signatures, run by the same templates of graph_search.h, so code written against a compressed_graph compiles against a compact_graph. The types are unsigned integers: the searches add weights into int distances, so floating point weights are not supported.
+ *
+ * Everything is in this header, since the class is a template.
+ */
+
+#include <limits>
+
+#include "compressed_graph.h"
+#include "graph_search.h"
+
+/**
+ * @class compact_graph
+ * @brief Read-only CSR representation of an undirected graph with VortexIndex neighbor indexes, EdgeWeight weights and EdgeOffset row offsets.
+ */
+template <class VortexIndex, class EdgeWeight, class EdgeOffset = unsigned int>
+class compact_graph
+{
+    static_assert(numeric_limits<VortexIndex>::is_integer && !numeric_limits<VortexIndex>::is_signed, "VortexIndex must be an unsigned integer type");
+    static_assert(numeric_limits<EdgeWeight>::is_integer && !numeric_limits<EdgeWeight>::is_signed, "EdgeWeight must be an unsigned integer type");
+    static_assert(numeric_limits<EdgeOffset>::is_integer && !numeric_limits<EdgeOffset>::is_signed, "EdgeOffset must be an unsigned integer type");
+
+public:
+    /**
+     * @brief Returns true if a graph fits the types: every vortex index in VortexIndex, every weight in EdgeWeight and the number of half edges in EdgeOffset.
+     */
+    static bool fits(const compressed_graph &graph)
+    {
+        unsigned int vortex_index_range = graph.get_vortex_index_range();
+        return (vortex_index_range == 0 || vortex_index_range - 1ULL <= (unsigned long long)numeric_limits<VortexIndex>::max()) &&
+               graph.get_max_edge_weight() <= (unsigned long long)numeric_limits<EdgeWeight>::max() &&
+               2 * graph.get_edge_number() <= (unsigned long long)numeric_limits<EdgeOffset>::max();
+    }
+
+    /**
+     * @brief Copies a compressed_graph into the compact types.
+     *
+     * @param graph The snapshot to copy, vortex indexes are kept.
+     *
+     * @return A dynamically allocated compact_graph, released by the caller with delete, or nullptr if the graph does not fit the types (see fits()).
+     */
+    static compact_graph *build(const compressed_graph &graph)
+    {
+        if (!fits(graph))
+            return nullptr;
+        compact_graph *compact = new compact_graph();
+        compact->vortex_index_range = graph.get_vortex_index_range();
+        compact->edge_number = 2 * graph.get_edge_number();
+        compact->max_edge_weight = graph.get_max_edge_weight();
+        compact->edge_offsets = new EdgeOffset[compact->vortex_index_range + 1ULL];
+        compact->neighbor_index = new VortexIndex[compact->edge_number];
+        compact->neighbor_weight = new EdgeWeight[compact->edge_number];
+
+        EdgeOffset position = 0;
+        for (unsigned int i = 0; i < compact->vortex_index_range; ++i)
+        {
+            compact->edge_offsets[i] = position;
+            graph.for_each_neighbor(i, [&](unsigned int neighbor, unsigned int edge_weight) {
+                compact->neighbor_index[position] = (VortexIndex)neighbor;
+                compact->neighbor_weight[position] = (EdgeWeight)edge_weight;
+                ++position;
+            });
+        }
+        compact->edge_offsets[compact->vortex_index_range] = position;
+        return compact;
+    }
+
+    /**
+     * @brief Destructor that frees the CSR arrays.
+     */
+    ~compact_graph()
+    {
+        delete[] this->edge_offsets;
+        delete[] this->neighbor_index;
+        delete[] this->neighbor_weight;
+    }
+
+    compact_graph(const compact_graph &) = delete;
+    compact_graph &operator=(const compact_graph &) = delete;
+
+    /**
+     * @brief Returns the size of the vortex index space (highest vortex index plus one).
+     */
+    unsigned int get_vortex_index_range() const
+    {
+        return this->vortex_index_range;
+    }
+
+    /**
+     * @brief Returns the number of undirected edges.
+     */
+    unsigned long long get_edge_number() const
+    {
+        return this->edge_number / 2;
+    }
+
+    /**
+     * @brief Returns the biggest edge weight.
+     */
+    unsigned int get_max_edge_weight() const
+    {
+        return this->max_edge_weight;
+    }
+
+    /**
+     * @brief Returns the number of neighbors of a vortex, 0 if the index is out of range.
+     */
+    unsigned int get_degree(unsigned int vortex_index) const
+    {
+        if (vortex_index >= this->vortex_index_range)
+            return 0;
+        return (unsigned int)(this->edge_offsets[vortex_index + 1] - this->edge_offsets[vortex_index]);
+    }
+
+    /**
+     * @brief Returns the bytes of the CSR arrays.
+     */
+    unsigned long long get_memory_usage() const
+    {
+        return (this->vortex_index_range + 1ULL) * sizeof(EdgeOffset) + this->edge_number * (sizeof(VortexIndex) + sizeof(EdgeWeight));
+    }
+
+    /**
+     * @brief Calls function(neighbor_index, edge_weight) for every neighbor of a vortex, widened to unsigned int.
+     *
+     * @param vortex_index The index of the vortex, must be lower than get_vortex_index_range().
+     * @param function Callable taking (unsigned int neighbor_index, unsigned int edge_weight).
+     */
+    template <class Function>
+    void for_each_neighbor(unsigned int vortex_index, Function function) const
+    {
+        EdgeOffset row_end = this->edge_offsets[vortex_index + 1];
+        for (EdgeOffset j = this->edge_offsets[vortex_index]; j < row_end; ++j)
+            function((unsigned int)this->neighbor_index[j], (unsigned int)this->neighbor_weight[j]);
+    }
+
+    /**
+     * @brief Returns true if predicate(neighbor_index, edge_weight) is true for some neighbor of a vortex, stopping at the first one.
+     */
+    template <class Predicate>
+    bool any_neighbor(unsigned int vortex_index, Predicate predicate) const
+    {
+        EdgeOffset row_end = this->edge_offsets[vortex_index + 1];
+        for (EdgeOffset j = this->edge_offsets[vortex_index]; j < row_end; ++j)
+            if (predicate((unsigned int)this->neighbor_index[j], (unsigned int)this->neighbor_weight[j]))
+                return true;
+        return false;
+    }
+
+    /**
+     * @brief Prints every undirected edge once, as compressed_graph::print_graph_edges().
+     */
+    void print_graph_edges() const
+    {
+        for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+        {
+            for_each_neighbor(i, [&](unsigned int neighbor, unsigned int edge_weight) {
+                if (neighbor > i)
+                    cout << "Edge between " << i << " and " << neighbor << " with weight: " << edge_weight << endl;
+            });
+        }
+    }
+
+    /**
+     * @brief Same as compressed_graph::search_shortest_distance_dijkstra(), prints the path found and returns its length, or -1.
+     */
+    int search_shortest_distance_dijkstra(unsigned int base_vortex, unsigned int goal_vortex, dijkstra_queue queue_type = DARY_HEAP_QUEUE) const
+    {
+        if (base_vortex >= this->vortex_index_range || goal_vortex >= this->vortex_index_range)
+        {
+            cout << "No path from " << base_vortex << " to " << goal_vortex << " found." << endl;
+            return -1;
+        }
+        return print_shortest_distance_dijkstra(*this, base_vortex, goal_vortex, queue_type, this->max_edge_weight);
+    }
+
+    /**
+     * @brief Same as compressed_graph::search_shortest_path(), a quiet Dijkstra search on the buffers of a search_context.
+     */
+    int search_shortest_path(search_context &context, unsigned int base_vortex, unsigned int goal_vortex, unsigned int *path, unsigned int path_capacity, unsigned int &path_length) const
+    {
+        path_length = 0;
+        if (base_vortex >= this->vortex_index_range || goal_vortex >= this->vortex_index_range)
+            return -1;
+        return shortest_path_dijkstra(*this, context, base_vortex, goal_vortex, path, path_capacity, path_length);
+    }
+
+    /**
+     * @brief Same as compressed_graph::search_shortest_path_bidirectional(), a bidirectional Dijkstra search.
+     */
+    int search_shortest_path_bidirectional(search_context &forward_context, search_context &backward_context, unsigned int base_vortex, unsigned int goal_vortex, unsigned int *path, unsigned int path_capacity, unsigned int &path_length) const
+    {
+        path_length = 0;
+        if (base_vortex >= this->vortex_index_range || goal_vortex >= this->vortex_index_range)
+            return -1;
+        return bidirectional_shortest_path_dijkstra(*this, forward_context, backward_context, base_vortex, goal_vortex, path, path_capacity, path_length);
+    }
+
+    /**
+     * @brief Same as compressed_graph::search_distance_matrix(), the distances between every source and every target.
+     */
+    int *search_distance_matrix(const unsigned int *source_vortexs, unsigned int source_number, const unsigned int *target_vortexs, unsigned int target_number, unsigned int thread_number = 1) const
+    {
+        int *distance_matrix = new int[(unsigned long long)source_number * target_number];
+        distance_matrix_dijkstra(*this, [](unsigned int) { return true; }, source_vortexs, source_number, target_vortexs, target_number, distance_matrix, thread_number);
+        return distance_matrix;
+    }
+
+    /**
+     * @brief Same as compressed_graph::search_all_distances(), parallel delta-stepping distances from a vortex.
+     */
+    int *search_all_distances(unsigned int base_vortex, unsigned int delta = 0, unsigned int thread_number = 1) const
+    {
+        int *distance_frombase = new int[this->vortex_index_range];
+        if (base_vortex >= this->vortex_index_range)
+        {
+            for (unsigned int i = 0; i < this->vortex_index_range; distance_frombase[i++] = -1)
+                ;
+            return distance_frombase;
+        }
+        if (delta == 0)
+            delta = this->max_edge_weight > 0 ? this->max_edge_weight : 1;
+        delta_stepping_distances(*this, base_vortex, delta, this->max_edge_weight, thread_number, distance_frombase);
+        for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+            if (distance_frombase[i] == numeric_limits<int>::max())
+                distance_frombase[i] = -1;
+        return distance_frombase;
+    }
+
+    /**
+     * @brief Same as compressed_graph::get_reachable_bitset(), a direction-optimizing breadth first search.
+     */
+    unsigned long long *get_reachable_bitset(unsigned int base_vortex, unsigned int thread_number = 1) const
+    {
+        unsigned long long *visited = new unsigned long long[bitset_words(this->vortex_index_range)]();
+        if (base_vortex < this->vortex_index_range)
+            parallel_breadth_first_search(*this, [](unsigned int) { return true; }, base_vortex, thread_number, visited);
+        return visited;
+    }
+
+    /**
+     * @brief Same as compressed_graph::get_component_labels(), the lowest vortex index of the component of every vortex.
+     */
+    unsigned int *get_component_labels(unsigned int &component_number, unsigned int thread_number = 1) const
+    {
+        unsigned int *component_label = new unsigned int[this->vortex_index_range];
+        component_number = connected_component_labels(*this, [](unsigned int) { return true; }, thread_number, component_label);
+        return component_label;
+    }
+
+    /**
+     * @brief Same as compressed_graph::get_full_reachable_vortexs(), 0 on the vortexes reachable from the base vortex and -1 on the rest.
+     */
+    int *get_full_reachable_vortexs(unsigned int base_vortex) const
+    {
+        if (base_vortex >= this->vortex_index_range)
+        {
+            int *ptr = new int[this->vortex_index_range];
+            for (unsigned int i = 0; i < this->vortex_index_range; ptr[i++] = -1)
+                ;
+            return ptr;
+        }
+        return reachable_vortexs_breadth_first(*this, base_vortex);
+    }
+
+private:
+    unsigned int vortex_index_range; /**< Highest vortex index plus one. */
+    unsigned long long edge_number;  /**< Stored half edges, twice the undirected edges. */
+    unsigned int max_edge_weight;    /**< Biggest edge weight. */
+    EdgeOffset *edge_offsets;        /**< vortex_index_range + 1 offsets into the neighbor and weight arrays. */
+    VortexIndex *neighbor_index;     /**< Neighbor of each half edge, sorted inside each vortex. */
+    EdgeWeight *neighbor_weight;     /**< Weight of each half edge. */
+
+    /**
+     * @brief Creates an empty graph, filled by build().
+     */
+    compact_graph()
+    {
+        this->vortex_index_range = 0;
+        this->edge_number = 0;
+        this->max_edge_weight = 0;
+        this->edge_offsets = nullptr;
+        this->neighbor_index = nullptr;
+        this->neighbor_weight = nullptr;
+    }
+};
+
+#endif
@@ -0,0 +1,234 @@
+#include <sys/mman.h>
+
+#include "compressed_graph.h"
+#include "graph_search.h"
+
+// Builds the CSR arrays in two passes over the list_graph: degree count, then fill
+compressed_graph::compressed_graph(const list_graph &graph)
+{
+	this->graph_name = graph.graph_name;
+	this->vortex_index_range = graph.vortex_index_range;
+	this->edge_number = 0;
+	this->max_edge_weight = 0;
+	this->file_mapping = nullptr;
+	this->file_mapping_size = 0;
+	vortex *current_vortex;
+
+	this->edge_offsets = new unsigned long long[this->vortex_index_range + 1]();
+
+	// first pass, degree of every vortex stored in edge_offsets[index + 1]
+	edge *current_edge;
+	for (current_vortex = graph.graph_head; current_vortex != nullptr; current_vortex = current_vortex->next)
+	{
+		for (current_edge = current_vortex->edge_ptr; current_edge != nullptr; current_edge = current_edge->next)
+		{
+			if (current_edge->vortex_index >= this->vortex_index_range || current_edge->vortex_index < current_vortex->vortex_index)
+				continue; // with symmetric storage every edge is taken from its lower index vortex
+			++this->edge_offsets[current_vortex->vortex_index + 1];
+			++this->edge_offsets[current_edge->vortex_index + 1];
+		}
+	}
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+		this->edge_offsets[i + 1] += this->edge_offsets[i];
+	this->edge_number = this->edge_offsets[this->vortex_index_range];
+
+	this->neighbor_index = new unsigned int[this->edge_number];
+	this->neighbor_weight = new unsigned int[this->edge_number];
+
+	// second pass, lower vortexes are visited first and every list is sorted, so each row is filled in ascending order
+	unsigned long long *fill_position = new unsigned long long[this->vortex_index_range];
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+		fill_position[i] = this->edge_offsets[i];
+
+	for (current_vortex = graph.graph_head; current_vortex != nullptr; current_vortex = current_vortex->next)
+	{
+		for (current_edge = current_vortex->edge_ptr; current_edge != nullptr; current_edge = current_edge->next)
+		{
+			if (current_edge->vortex_index >= this->vortex_index_range || current_edge->vortex_index < current_vortex->vortex_index)
+				continue; // with symmetric storage every edge is taken from its lower index vortex
+			unsigned long long position = fill_position[current_vortex->vortex_index]++;
+			this->neighbor_index[position] = current_edge->vortex_index;
+			this->neighbor_weight[position] = current_edge->edge_weight;
+			if (current_edge->edge_weight > this->max_edge_weight)
+				this->max_edge_weight = current_edge->edge_weight;
+
+			position = fill_position[current_edge->vortex_index]++;
+			this->neighbor_index[position] = current_vortex->vortex_index;
+			this->neighbor_weight[position] = current_edge->edge_weight;
+		}
+	}
+	delete[] fill_position;
+}
+
+// rows are filled visiting the new indexes in ascending order, so each row comes out sorted without sorting it
+compressed_graph::compressed_graph(const compressed_graph &graph, const unsigned int *new_index)
+{
+	this->graph_name = graph.graph_name;
+	this->vortex_index_range = graph.vortex_index_range;
+	this->edge_number = graph.edge_number;
+	this->max_edge_weight = graph.max_edge_weight;
+	this->file_mapping = nullptr;
+	this->file_mapping_size = 0;
+
+	unsigned int *original_index = new unsigned int[this->vortex_index_range];
+	this->edge_offsets = new unsigned long long[this->vortex_index_range + 1];
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+		original_index[new_index[i]] = i;
+	this->edge_offsets[0] = 0;
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+		this->edge_offsets[i + 1] = this->edge_offsets[i] + graph.get_degree(original_index[i]);
+
+	this->neighbor_index = new unsigned int[this->edge_number];
+	this->neighbor_weight = new unsigned int[this->edge_number];
+	unsigned long long *fill_position = new unsigned long long[this->vortex_index_range];
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+		fill_position[i] = this->edge_offsets[i];
+
+	// vortex i is written in the rows of its neighbors, after every lower new index
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+	{
+		graph.for_each_neighbor(original_index[i], [&](unsigned int neighbor, unsigned int edge_weight) {
+			unsigned long long position = fill_position[new_index[neighbor]]++;
+			this->neighbor_index[position] = i;
+			this->neighbor_weight[position] = edge_weight;
+		});
+	}
+	delete[] fill_position;
+	delete[] original_index;
+}
+
+// Destructor implementation
+compressed_graph::~compressed_graph()
+{
+	if (this->file_mapping != nullptr)
+	{
+		munmap(this->file_mapping, this->file_mapping_size); // the arrays point into the mapping
+		return;
+	}
+	delete[] this->edge_offsets;
+	delete[] this->neighbor_index;
+	delete[] this->neighbor_weight;
+}
+
+//////////////////////////////////////PUBLIC METHODS////////////////////////////////////////////////////////////////
+
+unsigned int compressed_graph::get_vortex_index_range() const
+{
+	return this->vortex_index_range;
+}
+
+unsigned long long compressed_graph::get_edge_number() const
+{
+	return this->edge_number / 2;
+}
+
+unsigned int compressed_graph::get_max_edge_weight() const
+{
+	return this->max_edge_weight;
+}
+
+unsigned int compressed_graph::get_degree(unsigned int vortex_index) const
+{
+	if (vortex_index >= this->vortex_index_range)
+		return 0;
+	return (unsigned int)(this->edge_offsets[vortex_index + 1] - this->edge_offsets[vortex_index]);
+}
+
+// Prints every undirected edge once, from the lower index vortex, as list_graph does
+void compressed_graph::print_graph_edges() const
+{
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+	{
+		for (unsigned long long j = this->edge_offsets[i]; j < this->edge_offsets[i + 1]; ++j)
+		{
+			if (this->neighbor_index[j] > i)
+				cout << "Edge between " << i << " and " << this->neighbor_index[j] << " with weight: " << this->neighbor_weight[j] << endl;
+		}
+	}
+}
+
+// Dijkstra over the CSR arrays, every neighbor of the current node is read from its own contiguous row
+int compressed_graph::search_shortest_distance_dijkstra(unsigned int base_vortex, unsigned int goal_vortex, dijkstra_queue queue_type) const
+{
+	if (base_vortex >= this->vortex_index_range || goal_vortex >= this->vortex_index_range)
+	{
+		cout << "No path from " << base_vortex << " to " << goal_vortex << " found." << endl;
+		return -1;
+	}
+	return print_shortest_distance_dijkstra(*this, base_vortex, goal_vortex, queue_type, this->max_edge_weight);
+}
+
+// quiet Dijkstra through shortest_path_dijkstra(), on the buffers of the caller's context
+int compressed_graph::search_shortest_path(search_context &context, unsigned int base_vortex, unsigned int goal_vortex, unsigned int *path, unsigned int path_capacity, unsigned int &path_length) const
+{
+	path_length = 0;
+	if (base_vortex >= this->vortex_index_range || goal_vortex >= this->vortex_index_range)
+		return -1;
+	return shortest_path_dijkstra(*this, context, base_vortex, goal_vortex, path, path_capacity, path_length);
+}
+
+// forward and backward searches through bidirectional_shortest_path_dijkstra()
+int compressed_graph::search_shortest_path_bidirectional(search_context &forward_context, search_context &backward_context, unsigned int base_vortex, unsigned int goal_vortex, unsigned int *path, unsigned int path_capacity, unsigned int &path_length) const
+{
+	path_length = 0;
+	if (base_vortex >= this->vortex_index_range || goal_vortex >= this->vortex_index_range)
+		return -1;
+	return bidirectional_shortest_path_dijkstra(*this, forward_context, backward_context, base_vortex, goal_vortex, path, path_capacity, path_length);
+}
+
+// distance matrix through distance_matrix_dijkstra(), every index of the snapshot is a vortex
+int *compressed_graph::search_distance_matrix(const unsigned int *source_vortexs, unsigned int source_number, const unsigned int *target_vortexs, unsigned int target_number, unsigned int thread_number) const
+{
+	int *distance_matrix = new int[(unsigned long long)source_number * target_number];
+	distance_matrix_dijkstra(*this, [](unsigned int) { return true; }, source_vortexs, source_number, target_vortexs, target_number, distance_matrix, thread_number);
+	return distance_matrix;
+}
+
+// returns an array of size vortex_index_range with 0 on reachable nodes, and -1 on unreachable from base_vortex
+int *compressed_graph::get_full_reachable_vortexs(unsigned int base_vortex) const
+{
+	if (base_vortex >= this->vortex_index_range)
+	{
+		int *ptr = new int[this->vortex_index_range];
+		for (unsigned int i = 0; i < this->vortex_index_range; ptr[i++] = -1)
+			;
+		return ptr;
+	}
+	return reachable_vortexs_breadth_first(*this, base_vortex);
+}
+
+// delta-stepping through delta_stepping_distances(), unreachable vortexes become -1
+int *compressed_graph::search_all_distances(unsigned int base_vortex, unsigned int delta, unsigned int thread_number) const
+{
+	int *distance_frombase = new int[this->vortex_index_range];
+	if (base_vortex >= this->vortex_index_range)
+	{
+		for (unsigned int i = 0; i < this->vortex_index_range; distance_frombase[i++] = -1)
+			;
+		return distance_frombase;
+	}
+	if (delta == 0)
+		delta = this->max_edge_weight > 0 ? this->max_edge_weight : 1;
+	delta_stepping_distances(*this, base_vortex, delta, this->max_edge_weight, thread_number, distance_frombase);
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+		if (distance_frombase[i] == numeric_limits<int>::max())
+			distance_frombase[i] = -1;
+	return distance_frombase;
+}
+
+// direction-optimizing breadth first search through parallel_breadth_first_search()
+unsigned long long *compressed_graph::get_reachable_bitset(unsigned int base_vortex, unsigned int thread_number) const
+{
+	unsigned long long *visited = new unsigned long long[bitset_words(this->vortex_index_range)]();
+	if (base_vortex < this->vortex_index_range)
+		parallel_breadth_first_search(*this, [](unsigned int) { return true; }, base_vortex, thread_number, visited);
+	return visited;
+}
+
+// Afforest through connected_component_labels(), every index of the snapshot is a vortex
+unsigned int *compressed_graph::get_component_labels(unsigned int &component_number, unsigned int thread_number) const
+{
+	unsigned int *component_label = new unsigned int[this->vortex_index_range];
+	component_number = connected_component_labels(*this, [](unsigned int) { return true; }, thread_number, component_label);
+	return component_label;
+}
@@ -0,0 +1,321 @@
+#ifndef COMPRESSED_GRAPH_H
+#define COMPRESSED_GRAPH_H
+
+/**
+ * @file compressed_graph.h
+ * @brief Immutable compressed sparse row (CSR) snapshot of a list_graph, for read-heavy query workloads.
+ *
+ * @author Fernando Elena Benavente
+ *
+ * A list_graph is cheap to modify, but every traversal pays a pointer chase (and usually a cache miss) per edge, and with the default lower index storage, where every edge is stored on its lower index vortex only, listing the neighbors of a vortex means scanning every lower index adjacency list.
+ *
+ * The compressed_graph is a frozen copy of the graph laid out in three contiguous arrays: one offsets array with an entry per vortex index, and the neighbor and weight arrays holding both directions of every undirected edge. The neighbors of vortex v are neighbor_index[edge_offsets[v]] .. neighbor_index[edge_offsets[v + 1] - 1], sorted by index. Each stored half edge costs 8 bytes (index plus weight) instead of the 24 bytes of an `edge` node.
+ *
+ * The snapshot does not follow later changes of the list_graph it was built from; freeze the graph again to pick them up.
+ *
+ * A snapshot can be saved to a versioned binary file, laid out exactly as the arrays in memory: a fixed header (magic, version, sizes, section positions and a checksum) followed by the graph name, the offsets, the neighbors and the weights, each section aligned to 8 bytes. map_file() memory maps such a file read-only and uses the sections in place, so a graph is ready to query without parsing or copying, and every process mapping the same file shares the same physical pages.
+ */
+
+#include "graph.h"
+#include "search_context.h"
+#include "simd_kernels.h"
+
+/**
+ * @class compressed_graph
+ * @brief Read-only CSR representation of an undirected graph.
+ *
+ * Built from a list_graph with list_graph::freeze() or directly with the constructor. Offers the same query algorithms as list_graph (Dijkstra shortest distance and reachability) running over contiguous memory.
+ */
+class compressed_graph
+{
+public:
+    /**
+     * @brief Builds the CSR snapshot of a list_graph.
+     *
+     * Vortex indexes are kept as they are in the source graph, so indexes not present in the list_graph (removed vortexes) are represented as vortexes without edges.
+     *
+     * @param graph The graph to freeze.
+     */
+    compressed_graph(const list_graph &graph);
+
+    /**
+     * @brief Builds a copy of a snapshot with its vortexes renumbered, vortex i of graph becoming vortex new_index[i].
+     *
+     * Used by reordered_graph to lay out neighbors close to each other. The rows stay sorted by the new indexes.
+     *
+     * @param graph The snapshot to copy, only read.
+     * @param new_index A permutation of 0 .. graph.get_vortex_index_range() - 1.
+     */
+    compressed_graph(const compressed_graph &graph, const unsigned int *new_index);
+
+    /**
+     * @brief Destructor that frees the CSR arrays, or unmaps the file of a mapped snapshot.
+     */
+    ~compressed_graph();
+
+    /**
+     * @brief Maps a file written by save() and returns a snapshot reading its arrays in place.
+     *
+     * The file is mapped read-only and shared, nothing is parsed or copied. The header is validated (magic, version, section positions against the file size), and so are the arrays the searches index with: the offsets must start at 0, never decrease and end at the number of half edges, every neighbor index must be in range and no weight may exceed the maximum weight of the header. That is one pass over the offsets, neighbors and weights, so a mapped file never makes a search read out of bounds. The checksum of the sections is only verified on request: it also catches corruption that keeps the arrays consistent (a changed weight or neighbor), which would give wrong distances but no invalid access.
+     *
+     * @param file_path Path of the graph file.
+     * @param verify_checksum If true, the checksum of the sections is recomputed and checked.
+     *
+     * @return A dynamically allocated snapshot, released with delete (which unmaps the file), or nullptr if the file cannot be opened or is not a valid graph file.
+     */
+    static compressed_graph *map_file(const char *file_path, bool verify_checksum = false);
+
+    /**
+     * @brief Writes the snapshot to a binary graph file that map_file() can load.
+     *
+     * @param file_path Path of the file to create or overwrite.
+     *
+     * @return 0 on success, -1 if the file cannot be created, or -2 if writing fails.
+     */
+    int save(const char *file_path) const;
+
+    compressed_graph(const compressed_graph &) = delete;
+    compressed_graph &operator=(const compressed_graph &) = delete;
+
+    /**
+     * @brief Returns the size of the vortex index space (highest vortex index plus one).
+     *
+     * Arrays returned or filled by the query methods are indexed by vortex index and have this size.
+     */
+    unsigned int get_vortex_index_range() const;
+
+    /**
+     * @brief Returns the number of undirected edges in the snapshot.
+     */
+    unsigned long long get_edge_number() const;
+
+    /**
+     * @brief Returns the number of neighbors of a vortex, 0 if the index is out of range.
+     *
+     * @param vortex_index The index of the vortex.
+     */
+    unsigned int get_degree(unsigned int vortex_index) const;
+
+    /**
+     * @brief Returns the biggest edge weight of the snapshot.
+     */
+    unsigned int get_max_edge_weight() const;
+
+    /**
+     * @brief Calls function(neighbor_index, edge_weight) for every neighbor of a vortex, reading its CSR row.
+     *
+     * @param vortex_index The index of the vortex, must be lower than get_vortex_index_range().
+     * @param function Callable taking (unsigned int neighbor_index, unsigned int edge_weight).
+     */
+    template <class Function>
+    void for_each_neighbor(unsigned int vortex_index, Function function) const
+    {
+        unsigned long long row_end = this->edge_offsets[vortex_index + 1];
+        for (unsigned long long j = this->edge_offsets[vortex_index]; j < row_end; ++j)
+            function(this->neighbor_index[j], this->neighbor_weight[j]);
+    }
+
+    /**
+     * @brief Returns true if predicate(neighbor_index, edge_weight) is true for some neighbor of a vortex, stopping at the first one.
+     *
+     * @param vortex_index The index of the vortex, must be lower than get_vortex_index_range().
+     * @param predicate Callable taking (unsigned int neighbor_index, unsigned int edge_weight) and returning bool.
+     */
+    template <class Predicate>
+    bool any_neighbor(unsigned int vortex_index, Predicate predicate) const
+    {
+        unsigned long long row_end = this->edge_offsets[vortex_index + 1];
+        for (unsigned long long j = this->edge_offsets[vortex_index]; j < row_end; ++j)
+            if (predicate(this->neighbor_index[j], this->neighbor_weight[j]))
+                return true;
+        return false;
+    }
+
+    /**
+     * @brief Points at the CSR row of a vortex and returns its number of neighbors, for the SIMD kernels of simd_kernels.h.
+     *
+     * @param vortex_index The index of the vortex, must be lower than get_vortex_index_range().
+     * @param neighbors Output, the neighbor indexes of the row.
+     * @param weights Output, the edge weights of the row.
+     */
+    unsigned int get_row(unsigned int vortex_index, const unsigned int *&neighbors, const unsigned int *&weights) const
+    {
+        unsigned long long row_begin = this->edge_offsets[vortex_index];
+        neighbors = this->neighbor_index + row_begin;
+        weights = this->neighbor_weight + row_begin;
+        return (unsigned int)(this->edge_offsets[vortex_index + 1] - row_begin);
+    }
+
+    /**
+     * @brief Prints the edges of the snapshot in the same format as list_graph::print_graph_edges().
+     *
+     * Each undirected edge is printed once, from its lower index vortex.
+     */
+    void print_graph_edges() const;
+
+    /**
+     * @brief Finds the shortest path between two vortexes using Dijkstra's algorithm.
+     *
+     * Same behaviour as list_graph::search_shortest_distance_dijkstra(): prints the path found and returns its length.
+     *
+     * @param base_vortex The index of the starting vortex.
+     * @param goal_vortex The index of the goal vortex.
+     * @param queue_type The priority queue used, a 4-ary heap by default, or Dial's bucket queue for small integer weights.
+     *
+     * @return The shortest distance, or -1 if the goal vortex is not reachable.
+     */
+    int search_shortest_distance_dijkstra(unsigned int base_vortex, unsigned int goal_vortex, dijkstra_queue queue_type = DARY_HEAP_QUEUE) const;
+
+    /**
+     * @brief Finds the shortest path between two vortexes and returns it, without printing or allocating.
+     *
+     * The quiet counterpart of search_shortest_distance_dijkstra() for query loops: the search runs on the buffers of a search_context owned by the caller, reused from one query to the next and reset lazily, and the path is copied to a caller-provided array. Each thread uses its own context.
+     *
+     * @param context The search buffers, see search_context.h.
+     * @param base_vortex The index of the starting vortex.
+     * @param goal_vortex The index of the goal vortex.
+     * @param path Output, the vortexes of the path from base_vortex to goal_vortex, both included. Only written if the path fits.
+     * @param path_capacity Number of elements of path.
+     * @param path_length Output, the number of vortexes of the path, 0 if there is none. When it is bigger than path_capacity, path is left untouched and the query can be repeated with a bigger array.
+     *
+     * @return The shortest distance, or -1 if the goal vortex is not reachable or a vortex does not exist.
+     */
+    int search_shortest_path(search_context &context, unsigned int base_vortex, unsigned int goal_vortex, unsigned int *path, unsigned int path_capacity, unsigned int &path_length) const;
+
+    /**
+     * @brief Finds the shortest path between two vortexes with a bidirectional Dijkstra search, without printing or allocating.
+     *
+     * Same result as search_shortest_path(), the distance is identical and the path is a shortest one (it can differ when several paths tie). A forward search from base_vortex and a backward search from goal_vortex run in turns until they meet, which settles far fewer vortexes on point to point queries. See bidirectional_shortest_path_dijkstra() in graph_search.h.
+     *
+     * @param forward_context The buffers of the forward search.
+     * @param backward_context The buffers of the backward search, a different context of the same thread.
+     * @param base_vortex The index of the starting vortex.
+     * @param goal_vortex The index of the goal vortex.
+     * @param path Output, the vortexes of the path from base_vortex to goal_vortex, both included. Only written if the path fits.
+     * @param path_capacity Number of elements of path.
+     * @param path_length Output, the number of vortexes of the path, 0 if there is none, also when it does not fit in path.
+     *
+     * @return The shortest distance, or -1 if the goal vortex is not reachable or a vortex does not exist.
+     */
+    int search_shortest_path_bidirectional(search_context &forward_context, search_context &backward_context, unsigned int base_vortex, unsigned int goal_vortex, unsigned int *path, unsigned int path_capacity, unsigned int &path_length) const;
+
+    /**
+     * @brief Computes the shortest distance between every source vortex and every target vortex, without printing.
+     *
+     * A distance matrix in one call instead of one search_shortest_distance_dijkstra() per pair: one Dijkstra search per source, stopped as soon as every target is settled, with the search arrays allocated once per worker thread and reset only where a search touched them. Sources are spread across thread_number threads. See distance_matrix_dijkstra() in graph_search.h.
+     *
+     * @param source_vortexs The source vortexes, the rows of the matrix.
+     * @param source_number Number of sources.
+     * @param target_vortexs The target vortexes, the columns of the matrix.
+     * @param target_number Number of targets.
+     * @param thread_number Number of threads searching sources in parallel.
+     *
+     * @return A dynamically allocated array of source_number * target_number distances, the distance from source i to target j at i * target_number + j, -1 where the target is not reachable or a vortex does not exist. Released by the caller with delete[].
+     */
+    int *search_distance_matrix(const unsigned int *source_vortexs, unsigned int source_number, const unsigned int *target_vortexs, unsigned int target_number, unsigned int thread_number = 1) const;
+
+    /**
+     * @brief Computes the distance from a vortex to every vortex with parallel delta-stepping, without printing.
+     *
+     * For full single source sweeps on big graphs: the buckets of delta-stepping are processed by thread_number threads at once, relaxing edges with an atomic minimum on the distances. The distances are exactly the ones of Dijkstra's algorithm. See delta_stepping_distances() in graph_search.h.
+     *
+     * @param base_vortex The index of the starting vortex.
+     * @param delta The bucket width, edges up to delta are relaxed inside their bucket and heavier ones once per bucket. 0 picks the maximum edge weight, making every edge light.
+     * @param thread_number Number of threads.
+     *
+     * @return A dynamically allocated array of get_vortex_index_range() distances, -1 on the vortexes not reachable from base_vortex (all of them if it does not exist). Released by the caller with delete[].
+     */
+    int *search_all_distances(unsigned int base_vortex, unsigned int delta = 0, unsigned int thread_number = 1) const;
+
+    /**
+     * @brief Returns the vortexes reachable from a base vortex as a bitset, one bit per vortex index.
+     *
+     * A compact replacement of get_full_reachable_vortexs(): bit (i & 63) of word i / 64 is set when vortex i is reachable, 8 bytes per 64 vortexes instead of 4 per vortex. The search is a direction-optimizing breadth first search run by thread_number threads, see parallel_breadth_first_search() in graph_search.h.
+     *
+     * @param base_vortex The index of the base vortex.
+     * @param thread_number Number of threads of the search.
+     *
+     * @return A dynamically allocated array of (get_vortex_index_range() + 63) / 64 words, all zero if the base vortex does not exist. Released by the caller with delete[].
+     */
+    unsigned long long *get_reachable_bitset(unsigned int base_vortex, unsigned int thread_number = 1) const;
+
+    /**
+     * @brief Labels every vortex with its connected component, the lowest vortex index of the component.
+     *
+     * Runs the parallel Afforest algorithm of connected_component_labels() in graph_search.h on thread_number threads. Two vortexes are connected if and only if they have the same label.
+     *
+     * @param component_number Output, the number of connected components.
+     * @param thread_number Number of threads.
+     *
+     * @return A dynamically allocated array of get_vortex_index_range() labels. Released by the caller with delete[].
+     */
+    unsigned int *get_component_labels(unsigned int &component_number, unsigned int thread_number = 1) const;
+
+    /**
+     * @brief Retrieves all reachable vortexes from a given base vortex.
+     *
+     * Returns a dynamically allocated array of get_vortex_index_range() elements, with 0 on the vortexes reachable from the base vortex and -1 on the rest. The caller releases it with delete[].
+     *
+     * @param base_vortex The index of the base vortex.
+     *
+     * @return A dynamically allocated array representing reachable vortexes.
+     */
+    int *get_full_reachable_vortexs(unsigned int base_vortex) const;
+
+private:
+    string graph_name;                  /**< The name of the graph the snapshot was taken from. */
+    unsigned int vortex_index_range;    /**< Highest vortex index plus one. */
+    unsigned long long edge_number;     /**< Number of stored half edges (twice the undirected edges). */
+    unsigned int max_edge_weight;       /**< Biggest edge weight, sizes Dial's bucket queue. */
+    unsigned long long *edge_offsets;   /**< vortex_index_range + 1 offsets into the neighbor arrays. */
+    unsigned int *neighbor_index;       /**< Target vortex of each half edge, sorted inside each vortex. */
+    unsigned int *neighbor_weight;      /**< Weight of each half edge. */
+    void *file_mapping;                 /**< Mapped file the arrays point into, nullptr if they were allocated. */
+    unsigned long long file_mapping_size; /**< Size of the mapped file. */
+
+    /**
+     * @brief Creates an empty snapshot, filled by map_file().
+     */
+    compressed_graph();
+
+    /**
+     * @brief Returns true if the offsets, neighbor indexes and weights are consistent, checked by map_file() on the arrays of a file.
+     */
+    bool has_valid_arrays() const;
+};
+
+/**
+ * @brief relax_neighbors() of graph_search.h over a CSR row, filtering the improved neighbors with simd_filter_relaxations() in blocks.
+ *
+ * The searches of graph_search.h find this overload instead of the generic one when they run on a compressed_graph.
+ */
+template <class Function>
+void relax_neighbors(const compressed_graph &graph, const search_context &context, unsigned int vortex_index, int vortex_distance, Function improved)
+{
+    const unsigned int RELAX_BLOCK = 256; // row positions filtered per call, bounds the stack buffer
+    unsigned int improved_position[RELAX_BLOCK];
+    const unsigned int *neighbors, *weights;
+    unsigned int degree = graph.get_row(vortex_index, neighbors, weights);
+    for (unsigned int block_begin = 0; block_begin < degree; block_begin += RELAX_BLOCK)
+    {
+        unsigned int block_size = degree - block_begin < RELAX_BLOCK ? degree - block_begin : RELAX_BLOCK;
+        unsigned int improved_number = context.filter_relaxations(neighbors + block_begin, weights + block_begin, block_size, vortex_distance, improved_position);
+        for (unsigned int i = 0; i < improved_number; ++i)
+        {
+            unsigned int j = block_begin + improved_position[i]; // a row holds no repeated neighbor, so the earlier calls cannot change this one
+            improved(neighbors[j], vortex_distance + (int)weights[j]);
+        }
+    }
+}
+
+/**
+ * @brief any_neighbor_in_bitset() of graph_search.h over a CSR row, with simd_any_in_bitset().
+ */
+inline bool any_neighbor_in_bitset(const compressed_graph &graph, unsigned int vortex_index, const unsigned long long *bitset)
+{
+    const unsigned int *neighbors, *weights;
+    unsigned int degree = graph.get_row(vortex_index, neighbors, weights);
+    return simd_any_in_bitset(neighbors, degree, bitset);
+}
+
+#endif
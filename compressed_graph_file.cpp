@@ -0,0 +1,149 @@
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "compressed_graph.h"
+#include "graph_file.h"
+
+static const char GRAPH_FILE_MAGIC[8] = {'M', 'E', 'G', 'G', 'C', 'S', 'R', '\0'};
+static const unsigned int GRAPH_FILE_VERSION = 1;
+
+// fixed header at the start of a graph file, every section position is a byte offset from the file start
+struct graph_file_header
+{
+	char magic[8];                        // GRAPH_FILE_MAGIC
+	unsigned int version;                 // GRAPH_FILE_VERSION
+	unsigned int header_size;             // sizeof(graph_file_header)
+	unsigned int vortex_index_range;      // highest vortex index plus one
+	unsigned int max_edge_weight;         // biggest edge weight
+	unsigned long long edge_number;       // stored half edges
+	unsigned long long name_length;       // bytes of the graph name, without terminator
+	unsigned long long name_position;     // graph name section
+	unsigned long long offsets_position;  // vortex_index_range + 1 unsigned long long offsets
+	unsigned long long neighbors_position;// edge_number unsigned int neighbor indexes
+	unsigned long long weights_position;  // edge_number unsigned int weights
+	unsigned long long file_size;         // total size, a multiple of 8
+	unsigned long long checksum;          // graph_file_checksum() of every byte after the header
+};
+
+compressed_graph::compressed_graph()
+{
+	this->vortex_index_range = 0;
+	this->edge_number = 0;
+	this->max_edge_weight = 0;
+	this->edge_offsets = nullptr;
+	this->neighbor_index = nullptr;
+	this->neighbor_weight = nullptr;
+	this->file_mapping = nullptr;
+	this->file_mapping_size = 0;
+}
+
+// writes the header with a zero checksum, then the sections, then rewrites the header with the checksum
+int compressed_graph::save(const char *file_path) const
+{
+	FILE *file = fopen(file_path, "wb");
+	if (file == nullptr)
+		return -1;
+
+	graph_file_header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic));
+	header.version = GRAPH_FILE_VERSION;
+	header.header_size = sizeof(graph_file_header);
+	header.vortex_index_range = this->vortex_index_range;
+	header.max_edge_weight = this->max_edge_weight;
+	header.edge_number = this->edge_number;
+	header.name_length = this->graph_name.size();
+	header.name_position = align_section(sizeof(graph_file_header));
+	header.offsets_position = header.name_position + align_section(header.name_length);
+	header.neighbors_position = header.offsets_position + align_section((this->vortex_index_range + 1ULL) * sizeof(unsigned long long));
+	header.weights_position = header.neighbors_position + align_section(this->edge_number * sizeof(unsigned int));
+	header.file_size = header.weights_position + align_section(this->edge_number * sizeof(unsigned int));
+
+	unsigned long long checksum = GRAPH_FILE_CHECKSUM_SEED;
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+				   write_section(file, this->graph_name.data(), header.name_length, checksum) &&
+				   write_section(file, this->edge_offsets, (this->vortex_index_range + 1ULL) * sizeof(unsigned long long), checksum) &&
+				   write_section(file, this->neighbor_index, this->edge_number * sizeof(unsigned int), checksum) &&
+				   write_section(file, this->neighbor_weight, this->edge_number * sizeof(unsigned int), checksum);
+
+	header.checksum = checksum;
+	written = written && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+	if (fclose(file) != 0 || !written)
+		return -2;
+	return 0;
+}
+
+// maps the whole file read-only and shared, and points the CSR arrays to their sections
+compressed_graph *compressed_graph::map_file(const char *file_path, bool verify_checksum)
+{
+	int file_descriptor = open(file_path, O_RDONLY);
+	if (file_descriptor < 0)
+		return nullptr;
+	struct stat file_status;
+	if (fstat(file_descriptor, &file_status) != 0 || (unsigned long long)file_status.st_size < sizeof(graph_file_header))
+	{
+		close(file_descriptor);
+		return nullptr;
+	}
+	unsigned long long file_size = file_status.st_size;
+	void *mapping = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, file_descriptor, 0);
+	close(file_descriptor); // the mapping keeps the file alive
+	if (mapping == MAP_FAILED)
+		return nullptr;
+
+	const unsigned char *bytes = (const unsigned char *)mapping;
+	graph_file_header header;
+	memcpy(&header, bytes, sizeof(header));
+
+	unsigned long long offsets_size = (header.vortex_index_range + 1ULL) * sizeof(unsigned long long);
+	unsigned long long edges_size = header.edge_number * sizeof(unsigned int);
+	bool valid = memcmp(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic)) == 0 &&
+				 header.version == GRAPH_FILE_VERSION && header.header_size == sizeof(graph_file_header) &&
+				 header.file_size == file_size && header.edge_number < file_size &&
+				 section_fits(header.name_position, header.name_length, file_size) &&
+				 header.offsets_position % 8 == 0 && section_fits(header.offsets_position, offsets_size, file_size) &&
+				 header.neighbors_position % 8 == 0 && section_fits(header.neighbors_position, edges_size, file_size) &&
+				 header.weights_position % 8 == 0 && section_fits(header.weights_position, edges_size, file_size);
+	if (valid && verify_checksum)
+		valid = graph_file_checksum(bytes + header.name_position, file_size - header.name_position) == header.checksum;
+	if (!valid)
+	{
+		munmap(mapping, file_size);
+		return nullptr;
+	}
+
+	compressed_graph *graph = new compressed_graph();
+	graph->graph_name.assign((const char *)bytes + header.name_position, header.name_length);
+	graph->vortex_index_range = header.vortex_index_range;
+	graph->edge_number = header.edge_number;
+	graph->max_edge_weight = header.max_edge_weight;
+	graph->edge_offsets = (unsigned long long *)(bytes + header.offsets_position);
+	graph->neighbor_index = (unsigned int *)(bytes + header.neighbors_position);
+	graph->neighbor_weight = (unsigned int *)(bytes + header.weights_position);
+	graph->file_mapping = mapping;
+	graph->file_mapping_size = file_size;
+	if (!graph->has_valid_arrays())
+	{
+		delete graph; // unmaps the file
+		return nullptr;
+	}
+	return graph;
+}
+
+// the searches index arrays with the offsets and the neighbors and size Dial's buckets with max_edge_weight,
+// so those are checked on every mapped file, checksum or not
+bool compressed_graph::has_valid_arrays() const
+{
+	if (!valid_row_offsets(this->edge_offsets, this->vortex_index_range, this->edge_number))
+		return false;
+	for (unsigned long long j = 0; j < this->edge_number; ++j)
+	{
+		if (this->neighbor_index[j] >= this->vortex_index_range || this->neighbor_weight[j] > this->max_edge_weight)
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,74 @@
+#include "concurrent_graph.h"
+
+concurrent_graph::concurrent_graph(const list_graph &graph, unsigned int reader_number)
+{
+	this->reader_number = reader_number;
+	// new[] only aligns over-aligned types from C++17, so the slots are placed at a cache line boundary by hand
+	this->reader_slot_memory = new unsigned char[(reader_number + 1) * sizeof(reader_slot)];
+	uintptr_t slot_address = ((uintptr_t)this->reader_slot_memory + alignof(reader_slot) - 1) & ~(uintptr_t)(alignof(reader_slot) - 1);
+	this->reader_slots = (reader_slot *)slot_address;
+	for (unsigned int i = 0; i < reader_number; ++i)
+	{
+		new (&this->reader_slots[i]) reader_slot;
+		this->reader_slots[i].epoch.store(IDLE_EPOCH);
+	}
+	this->global_epoch.store(IDLE_EPOCH + 1);
+	this->current_snapshot.store(graph.freeze());
+	this->published_number = 1;
+}
+
+concurrent_graph::~concurrent_graph()
+{
+	for (unsigned long long i = 0; i < this->retired.size(); ++i)
+		delete this->retired[i].snapshot;
+	delete this->current_snapshot.load();
+	for (unsigned int i = 0; i < this->reader_number; ++i)
+		this->reader_slots[i].~reader_slot();
+	delete[] this->reader_slot_memory;
+}
+
+// the exchange comes before the epoch advance, so a reader entering in the new epoch loads the new snapshot
+void concurrent_graph::publish(const list_graph &graph)
+{
+	compressed_graph *old_snapshot = this->current_snapshot.exchange(graph.freeze());
+	retired_snapshot retired_item;
+	retired_item.snapshot = old_snapshot;
+	retired_item.epoch = this->global_epoch.fetch_add(1) + 1;
+	this->retired.push_back(retired_item);
+	++this->published_number;
+	reclaim();
+}
+
+// a snapshot retired in epoch e can only be held by readers that entered before e, so it is freed once the
+// oldest epoch among the readers holding a snapshot is e or later
+unsigned int concurrent_graph::reclaim()
+{
+	unsigned long long oldest_epoch = this->global_epoch.load();
+	for (unsigned int i = 0; i < this->reader_number; ++i)
+	{
+		unsigned long long reader_epoch = this->reader_slots[i].epoch.load();
+		if (reader_epoch != IDLE_EPOCH && reader_epoch < oldest_epoch)
+			oldest_epoch = reader_epoch;
+	}
+
+	unsigned long long kept = 0;
+	for (unsigned long long i = 0; i < this->retired.size(); ++i)
+	{
+		if (this->retired[i].epoch <= oldest_epoch)
+			delete this->retired[i].snapshot;
+		else
+			this->retired[kept++] = this->retired[i];
+	}
+	this->retired.resize(kept);
+	return (unsigned int)kept;
+}
+
+unsigned long long concurrent_graph::get_published_number() const
+{
+	return this->published_number;
+}
+
+unsigned int concurrent_graph::get_reader_number() const
+{
+	return this->reader_number;
+}
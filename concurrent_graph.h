@@ -0,0 +1,120 @@
+#ifndef CONCURRENT_GRAPH_H
+#define CONCURRENT_GRAPH_H
+
+/**
+ * @file concurrent_graph.h
+ * @brief Versioned read-only snapshots of a list_graph for lock-free concurrent readers while one writer keeps updating it.
+ *
+ * @author Fernando Elena Benavente
+ *
+ * One writer thread owns the list_graph and applies add_edge(), remove_edge(), add_vortex() and the rest to it as usual, with no synchronization. When a batch of updates is done, it calls publish(), which freezes the graph into a compressed_graph and swaps it in as the current snapshot with a single atomic exchange. Readers never see the list_graph: they take the current snapshot with read_lock(), run any number of queries on it (the compressed_graph queries only read it, each reader with its own search_context), and give it back with read_unlock(). A reader never waits, and sees one consistent version of the graph for as long as it holds the snapshot, whatever the writer does meanwhile.
+ *
+ * Snapshots are reclaimed with epochs: every reader has a slot, on its own cache line, where read_lock() writes the global epoch it entered in, and publish() advances the global epoch and retires the old snapshot with the new epoch. A retired snapshot is freed once every reader holding a snapshot entered in its retire epoch or later, since those readers took the snapshot after the exchange. A reader that holds a snapshot for long only delays the freeing of the snapshots retired meanwhile, never the writer.
+ *
+ * publish() costs a freeze(), linear in the graph, so the writer should publish batches of updates rather than every single one; the staleness of the readers is the time between publishes.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+
+#include "compressed_graph.h"
+#include "dynamic_array.h"
+#include "graph.h"
+
+/**
+ * @class concurrent_graph
+ * @brief Current snapshot of a list_graph with epoch based reclamation of the replaced ones, for one writer and a fixed number of readers.
+ */
+class concurrent_graph
+{
+public:
+    /**
+     * @brief Publishes a first snapshot of a graph.
+     *
+     * @param graph The graph of the writer, only read.
+     * @param reader_number Number of reader slots, every reader thread uses its own index from 0 to reader_number - 1.
+     */
+    concurrent_graph(const list_graph &graph, unsigned int reader_number);
+
+    /**
+     * @brief Destructor that frees the current and the retired snapshots, no reader may hold one.
+     */
+    ~concurrent_graph();
+
+    concurrent_graph(const concurrent_graph &) = delete;
+    concurrent_graph &operator=(const concurrent_graph &) = delete;
+
+    /**
+     * @brief Takes the current snapshot, which stays valid until read_unlock() with the same reader index.
+     *
+     * Lock-free and wait-free, a reader holds at most one snapshot at a time.
+     *
+     * @param reader_index The slot of the calling reader thread, lower than the reader number.
+     *
+     * @return The snapshot to query, only read.
+     */
+    const compressed_graph *read_lock(unsigned int reader_index)
+    {
+        this->reader_slots[reader_index].epoch.store(this->global_epoch.load());
+        return this->current_snapshot.load();
+    }
+
+    /**
+     * @brief Gives back the snapshot taken by read_lock(), which must not be used afterwards.
+     *
+     * @param reader_index The slot of the calling reader thread.
+     */
+    void read_unlock(unsigned int reader_index)
+    {
+        this->reader_slots[reader_index].epoch.store(IDLE_EPOCH, std::memory_order_release);
+    }
+
+    /**
+     * @brief Freezes the graph and makes it the current snapshot, then frees the retired snapshots no reader can hold. Only called by the writer.
+     *
+     * @param graph The graph of the writer, only read.
+     */
+    void publish(const list_graph &graph);
+
+    /**
+     * @brief Frees the retired snapshots no reader can hold anymore. Only called by the writer, publish() already does it.
+     *
+     * @return The number of snapshots still retired, held or possibly held by a reader.
+     */
+    unsigned int reclaim();
+
+    /**
+     * @brief Returns the number of snapshots published, the first one included.
+     */
+    unsigned long long get_published_number() const;
+
+    /**
+     * @brief Returns the number of reader slots.
+     */
+    unsigned int get_reader_number() const;
+
+private:
+    static const unsigned long long IDLE_EPOCH = 0; /**< Epoch of a reader slot that holds no snapshot, published epochs start at 1. */
+
+    struct alignas(64) reader_slot
+    {
+        std::atomic<unsigned long long> epoch; /**< Global epoch read_lock() was called in, IDLE_EPOCH outside. */
+    };
+
+    struct retired_snapshot
+    {
+        compressed_graph *snapshot;   /**< Replaced snapshot, freed by reclaim(). */
+        unsigned long long epoch;     /**< Global epoch right after it was replaced. */
+    };
+
+    std::atomic<compressed_graph *> current_snapshot; /**< Snapshot returned by read_lock(). */
+    std::atomic<unsigned long long> global_epoch;     /**< Advanced by every publish(). */
+    unsigned char *reader_slot_memory;                /**< Memory of the reader slots, with room to align them. */
+    reader_slot *reader_slots;                        /**< One slot per reader thread, at the first 64 byte boundary of reader_slot_memory. */
+    unsigned int reader_number;                       /**< Number of reader slots. */
+    unsigned long long published_number;              /**< Snapshots published, written by the writer only. */
+    dynamic_array<retired_snapshot> retired;          /**< Replaced snapshots not freed yet, written by the writer only. */
+};
+
+#endif
@@ -0,0 +1,623 @@
+#include <atomic>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+#include "contraction_hierarchy.h"
+#include "dynamic_array.h"
+#include "graph_file.h"
+
+static const char HIERARCHY_FILE_MAGIC[8] = {'M', 'E', 'G', 'G', 'C', 'H', '\0', '\0'};
+static const unsigned int HIERARCHY_FILE_VERSION = 1;
+
+// fixed header at the start of a hierarchy file, every section position is a byte offset from the file start
+struct hierarchy_file_header
+{
+	char magic[8];                        // HIERARCHY_FILE_MAGIC
+	unsigned int version;                 // HIERARCHY_FILE_VERSION
+	unsigned int header_size;             // sizeof(hierarchy_file_header)
+	unsigned int vortex_index_range;      // highest vortex index plus one
+	unsigned int reserved;                // zero, keeps the next fields aligned
+	unsigned long long edge_number;       // upward edges
+	unsigned long long ranks_position;    // vortex_index_range unsigned int ranks
+	unsigned long long offsets_position;  // vortex_index_range + 1 unsigned long long offsets
+	unsigned long long neighbors_position;// edge_number unsigned int neighbor indexes
+	unsigned long long weights_position;  // edge_number unsigned int weights
+	unsigned long long middles_position;  // edge_number unsigned int middle vortexes
+	unsigned long long file_size;         // total size, a multiple of 8
+	unsigned long long checksum;          // graph_file_checksum() of every byte after the header
+};
+
+// an edge of the graph being contracted, from the vortex whose list holds it
+struct working_edge
+{
+	unsigned int neighbor;  // the other end
+	unsigned int weight;    // weight of the edge or shortcut
+	unsigned int middle;    // contracted vortex of a shortcut, NO_VORTEX for original edges
+};
+
+// a shortcut found by a witness search, added at the end of the round
+struct pending_shortcut
+{
+	unsigned int vortex1;
+	unsigned int vortex2;
+	unsigned int weight;
+	unsigned int middle;
+};
+
+// an upward edge on its way to the CSR arrays
+struct upward_edge
+{
+	unsigned int from_vortex;
+	unsigned int to_vortex;
+	unsigned int weight;
+	unsigned int middle;
+};
+
+// vortex states during the contraction
+static const unsigned char REMAINING = 0, CONTRACTING = 1, CONTRACTED = 2;
+
+// calls function(item, worker) for every item in [0, item_number), items are handed out in turns to
+// thread_number workers, the calling thread being worker 0
+template <class Function>
+static void run_on_threads(unsigned int thread_number, unsigned long long item_number, Function function)
+{
+	atomic<unsigned long long> next_item(0);
+	auto work = [&](unsigned int worker) {
+		for (unsigned long long item = next_item++; item < item_number; item = next_item++)
+			function(item, worker);
+	};
+	thread *workers = new thread[thread_number];
+	for (unsigned int t = 1; t < thread_number; ++t)
+		workers[t] = thread(work, t);
+	work(0);
+	for (unsigned int t = 1; t < thread_number; ++t)
+		workers[t].join();
+	delete[] workers;
+}
+
+// Witness searches around a vortex: for every pair of its neighbors (u, w), a Dijkstra from u that avoids the
+// vortex and the vortexes contracted in the same round looks for a path no longer than the one through the
+// vortex. The search stops once every neighbor after u is settled (is_target, a cleared array of the worker,
+// marks them meanwhile), past the longest path through the vortex from u, or after WITNESS_SETTLE_LIMIT settled
+// vortexes, in which case the missing witnesses count as shortcuts. Returns the number of shortcuts, and
+// appends them to shortcuts if it is not nullptr.
+static unsigned int find_shortcuts(unsigned int contracted_vortex, const dynamic_array<working_edge> *adjacency, const unsigned char *state,
+								   unsigned int vortex_index_range, search_context &context, bool *is_target, dynamic_array<pending_shortcut> *shortcuts)
+{
+	const dynamic_array<working_edge> &neighbors = adjacency[contracted_vortex];
+	unsigned int shortcut_number = 0;
+	for (unsigned long long i = 0; i + 1 < neighbors.size(); ++i)
+	{
+		unsigned int source = neighbors[i].neighbor;
+		unsigned int max_second_weight = 0;
+		for (unsigned long long j = i + 1; j < neighbors.size(); ++j)
+			if (neighbors[j].weight > max_second_weight)
+				max_second_weight = neighbors[j].weight;
+		long long max_distance = (long long)neighbors[i].weight + max_second_weight;
+		unsigned long long targets_left = neighbors.size() - i - 1;
+		for (unsigned long long j = i + 1; j < neighbors.size(); ++j)
+			is_target[neighbors[j].neighbor] = true;
+
+		context.begin_search(vortex_index_range);
+		dary_heap<int> &queue = context.get_queue();
+		context.set_reached(source, 0, search_context::NO_PREDECESSOR);
+		queue.push(source, 0);
+		unsigned int settled_number = 0;
+		unsigned int current_node;
+		int current_distance;
+		while (!queue.empty() && queue.top_key() <= max_distance && settled_number < contraction_hierarchy::WITNESS_SETTLE_LIMIT)
+		{
+			queue.pop(current_node, current_distance);
+			context.set_settled(current_node);
+			++settled_number;
+			if (is_target[current_node] && --targets_left == 0)
+				break; // every target is settled, their distances are final
+			const dynamic_array<working_edge> &edges = adjacency[current_node];
+			for (unsigned long long k = 0; k < edges.size(); ++k)
+			{
+				unsigned int neighbor = edges[k].neighbor;
+				if (neighbor == contracted_vortex || state[neighbor] != REMAINING)
+					continue; // witnesses avoid the vortexes contracted in this round
+				int new_distance = current_distance + (int)edges[k].weight;
+				if (!context.is_settled(neighbor) && new_distance < context.get_distance(neighbor))
+				{
+					context.set_reached(neighbor, new_distance, current_node);
+					queue.push(neighbor, new_distance);
+				}
+			}
+		}
+		queue.clear();
+
+		for (unsigned long long j = i + 1; j < neighbors.size(); ++j)
+		{
+			is_target[neighbors[j].neighbor] = false;
+			long long through_vortex = (long long)neighbors[i].weight + neighbors[j].weight;
+			if (context.get_distance(neighbors[j].neighbor) <= through_vortex)
+				continue; // a witness path, reached or settled, is as short as the path through the vortex
+			++shortcut_number;
+			if (shortcuts != nullptr)
+				shortcuts->push_back({source, neighbors[j].neighbor, (unsigned int)through_vortex, contracted_vortex});
+		}
+	}
+	return shortcut_number;
+}
+
+// adds an edge to the list of a vortex, or lowers the weight of the existing one
+static void add_or_lower_edge(dynamic_array<working_edge> &edges, unsigned int neighbor, unsigned int weight, unsigned int middle)
+{
+	for (unsigned long long k = 0; k < edges.size(); ++k)
+	{
+		if (edges[k].neighbor != neighbor)
+			continue;
+		if (weight < edges[k].weight)
+			edges[k] = {neighbor, weight, middle};
+		return;
+	}
+	edges.push_back({neighbor, weight, middle});
+}
+
+// removes an edge from the list of a vortex, the last edge takes its place
+static void remove_working_edge(dynamic_array<working_edge> &edges, unsigned int neighbor)
+{
+	for (unsigned long long k = 0; k < edges.size(); ++k)
+	{
+		if (edges[k].neighbor != neighbor)
+			continue;
+		edges[k] = edges[edges.size() - 1];
+		edges.resize(edges.size() - 1);
+		return;
+	}
+}
+
+// Contraction in rounds of independent sets: priorities of the changed vortexes are recomputed in parallel, the
+// remaining vortexes with a lower priority than all their remaining neighbors are selected, their shortcuts are
+// found in parallel, and the round is applied sequentially. The list of a contracted vortex is left as it was at
+// its contraction, holding its edges to higher ranked vortexes, and becomes its CSR row at the end.
+contraction_hierarchy::contraction_hierarchy(const compressed_graph &graph, unsigned int thread_number)
+{
+	this->vortex_index_range = graph.get_vortex_index_range();
+	this->file_mapping = nullptr;
+	this->file_mapping_size = 0;
+	if (thread_number == 0)
+		thread_number = 1;
+	unsigned int vortex_index_range = this->vortex_index_range;
+
+	dynamic_array<working_edge> *adjacency = new dynamic_array<working_edge>[vortex_index_range];
+	for (unsigned int i = 0; i < vortex_index_range; ++i)
+	{
+		adjacency[i].reserve(graph.get_degree(i));
+		graph.for_each_neighbor(i, [&](unsigned int neighbor, unsigned int edge_weight) {
+			adjacency[i].push_back({neighbor, edge_weight, NO_VORTEX});
+		});
+	}
+
+	unsigned char *state = new unsigned char[vortex_index_range]();
+	int *priority = new int[vortex_index_range];
+	unsigned int *contracted_neighbors = new unsigned int[vortex_index_range]();
+	bool *priority_dirty = new bool[vortex_index_range];
+	this->vortex_rank = new unsigned int[vortex_index_range];
+	dynamic_array<unsigned int> remaining, selected;
+	remaining.reserve(vortex_index_range);
+	for (unsigned int i = 0; i < vortex_index_range; ++i)
+	{
+		priority_dirty[i] = true;
+		remaining.push_back(i);
+	}
+
+	search_context *contexts = new search_context[thread_number];
+	bool *is_target = new bool[(unsigned long long)thread_number * vortex_index_range]();
+	dynamic_array<pending_shortcut> *shortcuts = new dynamic_array<pending_shortcut>[thread_number];
+	unsigned int next_rank = 0;
+
+	while (!remaining.empty())
+	{
+		// priority: edge difference plus contracted neighbors, which spreads the contraction over the graph
+		run_on_threads(thread_number, remaining.size(), [&](unsigned long long item, unsigned int worker) {
+			unsigned int vortex_index = remaining[item];
+			if (!priority_dirty[vortex_index])
+				return;
+			unsigned int shortcut_number = find_shortcuts(vortex_index, adjacency, state, vortex_index_range, contexts[worker], is_target + (unsigned long long)worker * vortex_index_range, nullptr);
+			priority[vortex_index] = (int)shortcut_number - (int)adjacency[vortex_index].size() + (int)contracted_neighbors[vortex_index];
+			priority_dirty[vortex_index] = false;
+		});
+
+		// independent set, ties broken by index so the smallest priority of the graph is always selected
+		run_on_threads(thread_number, remaining.size(), [&](unsigned long long item, unsigned int) {
+			unsigned int vortex_index = remaining[item];
+			const dynamic_array<working_edge> &edges = adjacency[vortex_index];
+			for (unsigned long long k = 0; k < edges.size(); ++k)
+			{
+				unsigned int neighbor = edges[k].neighbor;
+				if (priority[neighbor] < priority[vortex_index] || (priority[neighbor] == priority[vortex_index] && neighbor < vortex_index))
+					return;
+			}
+			state[vortex_index] = CONTRACTING;
+		});
+		selected.clear();
+		for (unsigned long long item = 0; item < remaining.size(); ++item)
+			if (state[remaining[item]] == CONTRACTING)
+				selected.push_back(remaining[item]);
+
+		run_on_threads(thread_number, selected.size(), [&](unsigned long long item, unsigned int worker) {
+			find_shortcuts(selected[item], adjacency, state, vortex_index_range, contexts[worker], is_target + (unsigned long long)worker * vortex_index_range, &shortcuts[worker]);
+		});
+
+		// the selected vortexes are not adjacent, their lists only lose edges to each other's neighbors
+		for (unsigned long long item = 0; item < selected.size(); ++item)
+		{
+			unsigned int vortex_index = selected[item];
+			this->vortex_rank[vortex_index] = next_rank++;
+			state[vortex_index] = CONTRACTED;
+			const dynamic_array<working_edge> &edges = adjacency[vortex_index];
+			for (unsigned long long k = 0; k < edges.size(); ++k)
+			{
+				remove_working_edge(adjacency[edges[k].neighbor], vortex_index);
+				++contracted_neighbors[edges[k].neighbor];
+				priority_dirty[edges[k].neighbor] = true;
+			}
+		}
+		for (unsigned int t = 0; t < thread_number; ++t)
+		{
+			for (unsigned long long k = 0; k < shortcuts[t].size(); ++k)
+			{
+				pending_shortcut &shortcut = shortcuts[t][k];
+				add_or_lower_edge(adjacency[shortcut.vortex1], shortcut.vortex2, shortcut.weight, shortcut.middle);
+				add_or_lower_edge(adjacency[shortcut.vortex2], shortcut.vortex1, shortcut.weight, shortcut.middle);
+			}
+			shortcuts[t].clear();
+		}
+
+		unsigned long long remaining_number = 0;
+		for (unsigned long long item = 0; item < remaining.size(); ++item)
+			if (state[remaining[item]] == REMAINING)
+				remaining[remaining_number++] = remaining[item];
+		remaining.resize(remaining_number);
+	}
+
+	// upward CSR, edges bucketed by higher ranked end first and then by row, so every row comes out sorted
+	this->edge_offsets = new unsigned long long[vortex_index_range + 1]();
+	unsigned long long *target_offsets = new unsigned long long[vortex_index_range + 1]();
+	for (unsigned int i = 0; i < vortex_index_range; ++i)
+	{
+		this->edge_offsets[i + 1] = adjacency[i].size();
+		for (unsigned long long k = 0; k < adjacency[i].size(); ++k)
+			++target_offsets[adjacency[i][k].neighbor + 1];
+	}
+	for (unsigned int i = 0; i < vortex_index_range; ++i)
+	{
+		this->edge_offsets[i + 1] += this->edge_offsets[i];
+		target_offsets[i + 1] += target_offsets[i];
+	}
+	this->edge_number = this->edge_offsets[vortex_index_range];
+
+	upward_edge *by_target = new upward_edge[this->edge_number];
+	for (unsigned int i = 0; i < vortex_index_range; ++i)
+	{
+		for (unsigned long long k = 0; k < adjacency[i].size(); ++k)
+		{
+			working_edge &current_edge = adjacency[i][k];
+			by_target[target_offsets[current_edge.neighbor]++] = {i, current_edge.neighbor, current_edge.weight, current_edge.middle};
+		}
+		adjacency[i].release();
+	}
+	this->neighbor_index = new unsigned int[this->edge_number];
+	this->neighbor_weight = new unsigned int[this->edge_number];
+	this->middle_vortex = new unsigned int[this->edge_number];
+	unsigned long long *fill_position = target_offsets; // reused, one position per row
+	for (unsigned int i = 0; i < vortex_index_range; ++i)
+		fill_position[i] = this->edge_offsets[i];
+	for (unsigned long long k = 0; k < this->edge_number; ++k)
+	{
+		unsigned long long position = fill_position[by_target[k].from_vortex]++;
+		this->neighbor_index[position] = by_target[k].to_vortex;
+		this->neighbor_weight[position] = by_target[k].weight;
+		this->middle_vortex[position] = by_target[k].middle;
+	}
+
+	delete[] by_target;
+	delete[] target_offsets;
+	delete[] shortcuts;
+	delete[] is_target;
+	delete[] contexts;
+	delete[] priority_dirty;
+	delete[] contracted_neighbors;
+	delete[] priority;
+	delete[] state;
+	delete[] adjacency;
+}
+
+contraction_hierarchy::contraction_hierarchy()
+{
+	this->vortex_index_range = 0;
+	this->edge_number = 0;
+	this->vortex_rank = nullptr;
+	this->edge_offsets = nullptr;
+	this->neighbor_index = nullptr;
+	this->neighbor_weight = nullptr;
+	this->middle_vortex = nullptr;
+	this->file_mapping = nullptr;
+	this->file_mapping_size = 0;
+}
+
+contraction_hierarchy::~contraction_hierarchy()
+{
+	if (this->file_mapping != nullptr)
+	{
+		munmap(this->file_mapping, this->file_mapping_size); // the arrays point into the mapping
+		return;
+	}
+	delete[] this->vortex_rank;
+	delete[] this->edge_offsets;
+	delete[] this->neighbor_index;
+	delete[] this->neighbor_weight;
+	delete[] this->middle_vortex;
+}
+
+//////////////////////////////////////PRIVATE METHODS////////////////////////////////////////////////////////////////
+
+// binary search of the higher ranked vortex on the row of the lower ranked one, the edge must exist
+unsigned long long contraction_hierarchy::find_upward_edge(unsigned int vortex1, unsigned int vortex2) const
+{
+	unsigned int row = this->vortex_rank[vortex1] < this->vortex_rank[vortex2] ? vortex1 : vortex2;
+	unsigned int target = row == vortex1 ? vortex2 : vortex1;
+	unsigned long long low = this->edge_offsets[row], high = this->edge_offsets[row + 1];
+	while (low < high)
+	{
+		unsigned long long middle = low + (high - low) / 2;
+		if (this->neighbor_index[middle] < target)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	return low;
+}
+
+// a shortcut is replaced by its two edges through the middle vortex, the recursion depth is bounded by the
+// number of levels of the hierarchy
+unsigned int contraction_hierarchy::unpack_edge(unsigned int vortex_from, unsigned int vortex_to, unsigned int *path, unsigned int path_capacity, unsigned int position) const
+{
+	unsigned int middle = this->middle_vortex[find_upward_edge(vortex_from, vortex_to)];
+	if (middle == NO_VORTEX)
+	{
+		if (position < path_capacity)
+			path[position] = vortex_to;
+		return 1;
+	}
+	unsigned int vortex_number = unpack_edge(vortex_from, middle, path, path_capacity, position);
+	return vortex_number + unpack_edge(middle, vortex_to, path, path_capacity, position + vortex_number);
+}
+
+//////////////////////////////////////PUBLIC METHODS////////////////////////////////////////////////////////////////
+
+unsigned int contraction_hierarchy::get_vortex_index_range() const
+{
+	return this->vortex_index_range;
+}
+
+unsigned long long contraction_hierarchy::get_edge_number() const
+{
+	return this->edge_number;
+}
+
+unsigned int contraction_hierarchy::get_rank(unsigned int vortex_index) const
+{
+	return this->vortex_rank[vortex_index];
+}
+
+// Both searches only go up in rank. A vortex settled by one side and reached by the other gives a candidate
+// distance, and a side stops once its smallest queued distance is no shorter than the best candidate. The path
+// goes up from the base to the meeting vortex and down to the goal, each hierarchy edge is unpacked in place.
+int contraction_hierarchy::search_shortest_path(search_context &forward_context, search_context &backward_context, unsigned int base_vortex, unsigned int goal_vortex, unsigned int *path, unsigned int path_capacity, unsigned int &path_length) const
+{
+	path_length = 0;
+	if (base_vortex >= this->vortex_index_range || goal_vortex >= this->vortex_index_range)
+		return -1;
+
+	forward_context.begin_search(this->vortex_index_range);
+	backward_context.begin_search(this->vortex_index_range);
+	dary_heap<int> &forward_queue = forward_context.get_queue();
+	dary_heap<int> &backward_queue = backward_context.get_queue();
+	forward_context.set_reached(base_vortex, 0, search_context::NO_PREDECESSOR);
+	forward_queue.push(base_vortex, 0);
+	backward_context.set_reached(goal_vortex, 0, search_context::NO_PREDECESSOR);
+	backward_queue.push(goal_vortex, 0);
+
+	long long best_distance = numeric_limits<int>::max();
+	unsigned int meeting_vortex = NO_VORTEX;
+	while (true)
+	{
+		if (!forward_queue.empty() && forward_queue.top_key() >= best_distance)
+			forward_queue.clear();
+		if (!backward_queue.empty() && backward_queue.top_key() >= best_distance)
+			backward_queue.clear();
+		if (forward_queue.empty() && backward_queue.empty())
+			break;
+
+		bool forward_side = !forward_queue.empty() && (backward_queue.empty() || forward_queue.top_key() <= backward_queue.top_key());
+		search_context &own_context = forward_side ? forward_context : backward_context;
+		search_context &other_context = forward_side ? backward_context : forward_context;
+		dary_heap<int> &own_queue = forward_side ? forward_queue : backward_queue;
+
+		unsigned int current_node;
+		int current_distance;
+		own_queue.pop(current_node, current_distance);
+		own_context.set_settled(current_node);
+		int other_distance = other_context.get_distance(current_node);
+		if (other_distance != numeric_limits<int>::max() && (long long)current_distance + other_distance < best_distance)
+		{
+			best_distance = (long long)current_distance + other_distance;
+			meeting_vortex = current_node;
+		}
+		for_each_neighbor(current_node, [&](unsigned int neighbor, unsigned int edge_weight) {
+			int new_distance = current_distance + (int)edge_weight;
+			if (!own_context.is_settled(neighbor) && new_distance < own_context.get_distance(neighbor))
+			{
+				own_context.set_reached(neighbor, new_distance, current_node);
+				own_queue.push(neighbor, new_distance);
+			}
+		});
+	}
+	if (meeting_vortex == NO_VORTEX)
+		return -1;
+
+	// length of the unpacked path: the base, then the unpacked edges up to the meeting vortex and down to the goal
+	unsigned int upward_length = 1;
+	for (unsigned int trace_node = meeting_vortex; forward_context.get_predecessor(trace_node) != search_context::NO_PREDECESSOR; trace_node = forward_context.get_predecessor(trace_node))
+		upward_length += unpack_edge(forward_context.get_predecessor(trace_node), trace_node, nullptr, 0, 0);
+	path_length = upward_length;
+	for (unsigned int trace_node = meeting_vortex; backward_context.get_predecessor(trace_node) != search_context::NO_PREDECESSOR; trace_node = backward_context.get_predecessor(trace_node))
+		path_length += unpack_edge(trace_node, backward_context.get_predecessor(trace_node), nullptr, 0, 0);
+	if (path_length > path_capacity)
+		return (int)best_distance;
+
+	// the upward part is walked from the meeting vortex back to the base, every edge ending where the next one was placed
+	unsigned int position = upward_length - 1;
+	for (unsigned int trace_node = meeting_vortex; forward_context.get_predecessor(trace_node) != search_context::NO_PREDECESSOR; trace_node = forward_context.get_predecessor(trace_node))
+	{
+		unsigned int previous_node = forward_context.get_predecessor(trace_node);
+		position -= unpack_edge(previous_node, trace_node, nullptr, 0, 0);
+		unpack_edge(previous_node, trace_node, path, path_capacity, position + 1);
+	}
+	path[0] = base_vortex;
+	position = upward_length;
+	for (unsigned int trace_node = meeting_vortex; backward_context.get_predecessor(trace_node) != search_context::NO_PREDECESSOR; trace_node = backward_context.get_predecessor(trace_node))
+		position += unpack_edge(trace_node, backward_context.get_predecessor(trace_node), path, path_capacity, position);
+	return (int)best_distance;
+}
+
+// writes the header with a zero checksum, then the sections, then rewrites the header with the checksum
+int contraction_hierarchy::save(const char *file_path) const
+{
+	FILE *file = fopen(file_path, "wb");
+	if (file == nullptr)
+		return -1;
+
+	hierarchy_file_header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, HIERARCHY_FILE_MAGIC, sizeof(header.magic));
+	header.version = HIERARCHY_FILE_VERSION;
+	header.header_size = sizeof(hierarchy_file_header);
+	header.vortex_index_range = this->vortex_index_range;
+	header.edge_number = this->edge_number;
+	header.ranks_position = align_section(sizeof(hierarchy_file_header));
+	header.offsets_position = header.ranks_position + align_section(this->vortex_index_range * sizeof(unsigned int));
+	header.neighbors_position = header.offsets_position + align_section((this->vortex_index_range + 1ULL) * sizeof(unsigned long long));
+	header.weights_position = header.neighbors_position + align_section(this->edge_number * sizeof(unsigned int));
+	header.middles_position = header.weights_position + align_section(this->edge_number * sizeof(unsigned int));
+	header.file_size = header.middles_position + align_section(this->edge_number * sizeof(unsigned int));
+
+	unsigned long long checksum = GRAPH_FILE_CHECKSUM_SEED;
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+				   write_section(file, this->vortex_rank, this->vortex_index_range * sizeof(unsigned int), checksum) &&
+				   write_section(file, this->edge_offsets, (this->vortex_index_range + 1ULL) * sizeof(unsigned long long), checksum) &&
+				   write_section(file, this->neighbor_index, this->edge_number * sizeof(unsigned int), checksum) &&
+				   write_section(file, this->neighbor_weight, this->edge_number * sizeof(unsigned int), checksum) &&
+				   write_section(file, this->middle_vortex, this->edge_number * sizeof(unsigned int), checksum);
+
+	header.checksum = checksum;
+	written = written && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+	if (fclose(file) != 0 || !written)
+		return -2;
+	return 0;
+}
+
+// maps the whole file read-only and shared, and points the arrays to their sections
+contraction_hierarchy *contraction_hierarchy::map_file(const char *file_path, bool verify_checksum)
+{
+	int file_descriptor = open(file_path, O_RDONLY);
+	if (file_descriptor < 0)
+		return nullptr;
+	struct stat file_status;
+	if (fstat(file_descriptor, &file_status) != 0 || (unsigned long long)file_status.st_size < sizeof(hierarchy_file_header))
+	{
+		close(file_descriptor);
+		return nullptr;
+	}
+	unsigned long long file_size = file_status.st_size;
+	void *mapping = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, file_descriptor, 0);
+	close(file_descriptor); // the mapping keeps the file alive
+	if (mapping == MAP_FAILED)
+		return nullptr;
+
+	const unsigned char *bytes = (const unsigned char *)mapping;
+	hierarchy_file_header header;
+	memcpy(&header, bytes, sizeof(header));
+
+	unsigned long long ranks_size = header.vortex_index_range * sizeof(unsigned int);
+	unsigned long long offsets_size = (header.vortex_index_range + 1ULL) * sizeof(unsigned long long);
+	unsigned long long edges_size = header.edge_number * sizeof(unsigned int);
+	bool valid = memcmp(header.magic, HIERARCHY_FILE_MAGIC, sizeof(header.magic)) == 0 &&
+				 header.version == HIERARCHY_FILE_VERSION && header.header_size == sizeof(hierarchy_file_header) &&
+				 header.file_size == file_size && header.edge_number < file_size &&
+				 header.ranks_position % 8 == 0 && section_fits(header.ranks_position, ranks_size, file_size) &&
+				 header.offsets_position % 8 == 0 && section_fits(header.offsets_position, offsets_size, file_size) &&
+				 header.neighbors_position % 8 == 0 && section_fits(header.neighbors_position, edges_size, file_size) &&
+				 header.weights_position % 8 == 0 && section_fits(header.weights_position, edges_size, file_size) &&
+				 header.middles_position % 8 == 0 && section_fits(header.middles_position, edges_size, file_size);
+	if (valid && verify_checksum)
+		valid = graph_file_checksum(bytes + header.ranks_position, file_size - header.ranks_position) == header.checksum;
+	if (!valid)
+	{
+		munmap(mapping, file_size);
+		return nullptr;
+	}
+
+	contraction_hierarchy *hierarchy = new contraction_hierarchy();
+	hierarchy->vortex_index_range = header.vortex_index_range;
+	hierarchy->edge_number = header.edge_number;
+	hierarchy->vortex_rank = (unsigned int *)(bytes + header.ranks_position);
+	hierarchy->edge_offsets = (unsigned long long *)(bytes + header.offsets_position);
+	hierarchy->neighbor_index = (unsigned int *)(bytes + header.neighbors_position);
+	hierarchy->neighbor_weight = (unsigned int *)(bytes + header.weights_position);
+	hierarchy->middle_vortex = (unsigned int *)(bytes + header.middles_position);
+	hierarchy->file_mapping = mapping;
+	hierarchy->file_mapping_size = file_size;
+	if (!hierarchy->has_valid_arrays())
+	{
+		delete hierarchy; // unmaps the file
+		return nullptr;
+	}
+	return hierarchy;
+}
+
+// the ranks must be a permutation and every edge must go up, from a sorted row; the two edges of a shortcut must
+// exist on the row of its middle vortex, ranked below both ends, so unpack_edge() finds them and every recursion
+// step moves to a lower ranked row and ends
+bool contraction_hierarchy::has_valid_arrays() const
+{
+	if (!valid_row_offsets(this->edge_offsets, this->vortex_index_range, this->edge_number))
+		return false;
+	bool *rank_used = new bool[this->vortex_index_range]();
+	bool valid = true;
+	for (unsigned int i = 0; i < this->vortex_index_range && valid; ++i)
+	{
+		valid = this->vortex_rank[i] < this->vortex_index_range && !rank_used[this->vortex_rank[i]];
+		if (valid)
+			rank_used[this->vortex_rank[i]] = true;
+	}
+	delete[] rank_used;
+
+	for (unsigned int i = 0; i < this->vortex_index_range && valid; ++i)
+	{
+		for (unsigned long long j = this->edge_offsets[i]; j < this->edge_offsets[i + 1] && valid; ++j)
+		{
+			unsigned int neighbor = this->neighbor_index[j], middle = this->middle_vortex[j];
+			valid = neighbor < this->vortex_index_range && this->vortex_rank[neighbor] > this->vortex_rank[i] &&
+					(j == this->edge_offsets[i] || this->neighbor_index[j - 1] < neighbor);
+			if (valid && middle != NO_VORTEX)
+				valid = middle < this->vortex_index_range && this->vortex_rank[middle] < this->vortex_rank[i] &&
+						has_upward_edge(middle, i) && has_upward_edge(middle, neighbor);
+		}
+	}
+	return valid;
+}
+
+// find_upward_edge() on a row not known to hold the edge
+bool contraction_hierarchy::has_upward_edge(unsigned int lower_vortex, unsigned int higher_vortex) const
+{
+	unsigned long long position = find_upward_edge(lower_vortex, higher_vortex);
+	return position < this->edge_offsets[lower_vortex + 1] && this->neighbor_index[position] == higher_vortex;
+}
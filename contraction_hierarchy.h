@@ -0,0 +1,162 @@
+#ifndef CONTRACTION_HIERARCHY_H
+#define CONTRACTION_HIERARCHY_H
+
+/**
+ * @file contraction_hierarchy.h
+ * @brief Contraction Hierarchy of a compressed_graph, for sub-millisecond point to point queries on static road-like graphs.
+ *
+ * @author Fernando Elena Benavente
+ *
+ * Preprocessing contracts the vortexes one by one in a chosen order: a contracted vortex is taken out of the graph, and every pair of its neighbors whose shortest path went through it is linked by a shortcut edge, whose middle vortex is the contracted one. Whether a shortcut is needed is decided by a witness search, a small Dijkstra between the two neighbors that avoids the vortex; if it finds a path as short as the one through the vortex, no shortcut is added. The order is the rank of every vortex.
+ *
+ * A shortest path then always goes up in rank and then down, so a query runs two Dijkstra searches, from the base and from the goal, that only follow edges to higher ranked vortexes, and meet at the highest vortex of the path. Both searches settle a few hundred vortexes on road graphs, whatever the graph size.
+ *
+ * The graph is undirected, so the upward edges of the forward search and the reversed downward edges of the backward search are the same edges: only the upward graph is stored, in CSR form, each edge on the row of its lower ranked vortex with the index of its higher ranked vortex, its weight and its middle vortex (NO_VORTEX for original edges). A shortcut with middle vortex m is made of the two edges between m and its ends, both stored on the row of m, since m has the lowest rank of the three, so paths are unpacked to original edges by looking up those edges.
+ *
+ * The order is built in rounds, as in parallel contraction: every round takes the remaining vortexes whose priority (edge difference plus contracted neighbors) is lower than the priority of all their remaining neighbors, an independent set, and contracts them together. The priorities and the witness searches of a round only read the graph, so they run on thread_number threads; the shortcuts are then added in one sequential pass. The witness searches of a round avoid every vortex contracted in that round.
+ *
+ * A hierarchy can be saved to a binary file laid out as its arrays, in the format of compressed_graph::save(), and mapped back read-only with map_file(), so preprocessing runs once per graph version.
+ */
+
+#include <limits>
+
+#include "compressed_graph.h"
+#include "search_context.h"
+
+/**
+ * @class contraction_hierarchy
+ * @brief Upward CSR graph of a Contraction Hierarchy, with a bidirectional upward query and path unpacking.
+ */
+class contraction_hierarchy
+{
+public:
+    static const unsigned int NO_VORTEX = std::numeric_limits<unsigned int>::max(); /**< Middle vortex of the original edges. */
+    static const unsigned int WITNESS_SETTLE_LIMIT = 500;                          /**< Vortexes a witness search settles before giving up and keeping the shortcut. */
+
+    /**
+     * @brief Builds the hierarchy of a graph.
+     *
+     * @param graph The graph to preprocess, its vortex indexes are kept.
+     * @param thread_number Number of threads of the priority and witness searches.
+     */
+    contraction_hierarchy(const compressed_graph &graph, unsigned int thread_number = 1);
+
+    /**
+     * @brief Destructor that frees the arrays, or unmaps the file of a mapped hierarchy.
+     */
+    ~contraction_hierarchy();
+
+    contraction_hierarchy(const contraction_hierarchy &) = delete;
+    contraction_hierarchy &operator=(const contraction_hierarchy &) = delete;
+
+    /**
+     * @brief Writes the hierarchy to a binary file that map_file() can load.
+     *
+     * @param file_path Path of the file to create or overwrite.
+     *
+     * @return 0 on success, -1 if the file cannot be created, or -2 if writing fails.
+     */
+    int save(const char *file_path) const;
+
+    /**
+     * @brief Maps a file written by save() and returns a hierarchy reading its arrays in place.
+     *
+     * The header and the section bounds are validated, and so are the arrays the queries follow, in one pass over the file: the ranks must be a permutation, the offsets must start at 0, never decrease and end at the number of edges, every edge must go to a higher ranked vortex in a sorted row, and the two edges of every shortcut must exist on the row of its middle vortex, ranked below both ends. A mapped file never makes a query read out of bounds or unpack a shortcut without end. The checksum is only verified on request; it also catches corruption that keeps the arrays consistent, such as a changed weight.
+     *
+     * @param file_path Path of the hierarchy file.
+     * @param verify_checksum If true, the checksum of the sections is recomputed and checked.
+     *
+     * @return A dynamically allocated hierarchy, released with delete (which unmaps the file), or nullptr if the file cannot be opened or is not a valid hierarchy file.
+     */
+    static contraction_hierarchy *map_file(const char *file_path, bool verify_checksum = false);
+
+    /**
+     * @brief Returns the size of the vortex index space of the preprocessed graph.
+     */
+    unsigned int get_vortex_index_range() const;
+
+    /**
+     * @brief Returns the number of upward edges, original edges plus shortcuts.
+     */
+    unsigned long long get_edge_number() const;
+
+    /**
+     * @brief Returns the contraction rank of a vortex, 0 for the first contracted one.
+     *
+     * @param vortex_index The index of the vortex, must be lower than get_vortex_index_range().
+     */
+    unsigned int get_rank(unsigned int vortex_index) const;
+
+    /**
+     * @brief Calls function(neighbor_index, edge_weight) for every upward edge of a vortex, the edges to its higher ranked neighbors.
+     *
+     * With this method the hierarchy can be searched by the templates of graph_search.h, which then follow upward edges only.
+     *
+     * @param vortex_index The index of the vortex, must be lower than get_vortex_index_range().
+     * @param function Callable taking (unsigned int neighbor_index, unsigned int edge_weight).
+     */
+    template <class Function>
+    void for_each_neighbor(unsigned int vortex_index, Function function) const
+    {
+        unsigned long long row_end = this->edge_offsets[vortex_index + 1];
+        for (unsigned long long j = this->edge_offsets[vortex_index]; j < row_end; ++j)
+            function(this->neighbor_index[j], this->neighbor_weight[j]);
+    }
+
+    /**
+     * @brief Finds the shortest path between two vortexes with a bidirectional upward search, and unpacks it to original edges.
+     *
+     * Same distance as the Dijkstra searches of the graph the hierarchy was built from. Nothing is allocated or printed, the searches run on the buffers of the contexts.
+     *
+     * @param forward_context The buffers of the search from base_vortex.
+     * @param backward_context The buffers of the search from goal_vortex, a different context.
+     * @param base_vortex The index of the starting vortex.
+     * @param goal_vortex The index of the goal vortex.
+     * @param path Output, the vortexes of the unpacked path from base_vortex to goal_vortex, both included, consecutive vortexes joined by original edges. Only written if the path fits.
+     * @param path_capacity Number of elements of path.
+     * @param path_length Output, the number of vortexes of the unpacked path, 0 if there is none, also when it does not fit in path.
+     *
+     * @return The shortest distance, or -1 if the goal vortex is not reachable or a vortex index is out of range.
+     */
+    int search_shortest_path(search_context &forward_context, search_context &backward_context, unsigned int base_vortex, unsigned int goal_vortex, unsigned int *path, unsigned int path_capacity, unsigned int &path_length) const;
+
+private:
+    unsigned int vortex_index_range;    /**< Highest vortex index plus one. */
+    unsigned long long edge_number;     /**< Number of upward edges. */
+    unsigned int *vortex_rank;          /**< Contraction rank of every vortex index. */
+    unsigned long long *edge_offsets;   /**< vortex_index_range + 1 offsets into the upward edge arrays. */
+    unsigned int *neighbor_index;       /**< Higher ranked end of each upward edge, sorted inside each vortex. */
+    unsigned int *neighbor_weight;      /**< Weight of each upward edge. */
+    unsigned int *middle_vortex;        /**< Contracted vortex a shortcut skips, NO_VORTEX for original edges. */
+    void *file_mapping;                 /**< Mapped file the arrays point into, nullptr if they were allocated. */
+    unsigned long long file_mapping_size; /**< Size of the mapped file. */
+
+    /**
+     * @brief Creates an empty hierarchy, filled by map_file().
+     */
+    contraction_hierarchy();
+
+    /**
+     * @brief Returns the position of the upward edge between two vortexes in the edge arrays, on the row of the lower ranked one.
+     */
+    unsigned long long find_upward_edge(unsigned int vortex1, unsigned int vortex2) const;
+
+    /**
+     * @brief Returns true if the row of lower_vortex holds an upward edge to higher_vortex.
+     */
+    bool has_upward_edge(unsigned int lower_vortex, unsigned int higher_vortex) const;
+
+    /**
+     * @brief Returns true if the ranks, offsets, upward edges and middle vortexes are consistent, checked by map_file() on the arrays of a file.
+     */
+    bool has_valid_arrays() const;
+
+    /**
+     * @brief Unpacks the edge between two vortexes into original edges, counting the vortexes after vortex_from and writing them to path from position when they fit.
+     *
+     * @return The number of vortexes of the unpacked edge, vortex_to included and vortex_from excluded.
+     */
+    unsigned int unpack_edge(unsigned int vortex_from, unsigned int vortex_to, unsigned int *path, unsigned int path_capacity, unsigned int position) const;
+};
+
+#endif
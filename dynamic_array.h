@@ -0,0 +1,129 @@
+#ifndef DYNAMIC_ARRAY_H
+#define DYNAMIC_ARRAY_H
+
+/**
+ * @file dynamic_array.h
+ * @brief Minimal growable array of plain structs, for buffers whose final size is not known in advance.
+ *
+ * @author Fernando Elena Benavente
+ *
+ * The project keeps control of its memory instead of using `vector`, this is the one growable buffer it needs: items are plain structs copied with memcpy, the capacity doubles when full, and nothing is constructed or destroyed per item.
+ */
+
+#include <cstring>
+
+/**
+ * @class dynamic_array
+ * @brief Growable array of trivially copyable items.
+ *
+ * @tparam T The item type, a plain struct or scalar.
+ */
+template <typename T>
+class dynamic_array
+{
+public:
+    dynamic_array()
+    {
+        this->items = nullptr;
+        this->item_number = 0;
+        this->capacity = 0;
+    }
+
+    ~dynamic_array()
+    {
+        delete[] this->items;
+    }
+
+    dynamic_array(const dynamic_array &) = delete;
+    dynamic_array &operator=(const dynamic_array &) = delete;
+
+    /**
+     * @brief Appends an item, doubling the capacity if the array is full.
+     */
+    void push_back(const T &item)
+    {
+        if (this->item_number == this->capacity)
+            reserve(this->capacity < 16 ? 16 : this->capacity * 2);
+        this->items[this->item_number++] = item;
+    }
+
+    /**
+     * @brief Makes room for at least new_capacity items.
+     */
+    void reserve(unsigned long long new_capacity)
+    {
+        if (new_capacity <= this->capacity)
+            return;
+        T *new_items = new T[new_capacity];
+        if (this->item_number > 0)
+            memcpy(new_items, this->items, this->item_number * sizeof(T));
+        delete[] this->items;
+        this->items = new_items;
+        this->capacity = new_capacity;
+    }
+
+    /**
+     * @brief Sets the number of items, growing the capacity if needed. New items are left uninitialized.
+     */
+    void resize(unsigned long long new_size)
+    {
+        reserve(new_size);
+        this->item_number = new_size;
+    }
+
+    /**
+     * @brief Removes every item, keeping the capacity.
+     */
+    void clear()
+    {
+        this->item_number = 0;
+    }
+
+    /**
+     * @brief Removes every item and frees the memory.
+     */
+    void release()
+    {
+        delete[] this->items;
+        this->items = nullptr;
+        this->item_number = 0;
+        this->capacity = 0;
+    }
+
+    unsigned long long size() const
+    {
+        return this->item_number;
+    }
+
+    bool empty() const
+    {
+        return this->item_number == 0;
+    }
+
+    T *data()
+    {
+        return this->items;
+    }
+
+    const T *data() const
+    {
+        return this->items;
+    }
+
+    T &operator[](unsigned long long position)
+    {
+        return this->items[position];
+    }
+
+    const T &operator[](unsigned long long position) const
+    {
+        return this->items[position];
+    }
+
+private:
+    T *items;                       /**< Item storage. */
+    unsigned long long item_number; /**< Items in use. */
+    unsigned long long capacity;    /**< Items allocated. */
+};
+
+#endif
@@ -0,0 +1,299 @@
+#include "dynamic_shortest_paths.h"
+#include "graph_search.h"
+
+static const int UNREACHED_DISTANCE = numeric_limits<int>::max();
+
+dynamic_shortest_paths::dynamic_shortest_paths(list_graph &graph)
+{
+	this->graph = &graph;
+	this->capacity = 0;
+	this->queue = nullptr;
+	this->affected_stamp = nullptr;
+	this->repair_stamp = 0;
+	this->last_repair_size = 0;
+	reserve(graph.get_vortex_index_range());
+}
+
+dynamic_shortest_paths::~dynamic_shortest_paths()
+{
+	for (unsigned long long i = 0; i < this->trees.size(); ++i)
+	{
+		delete[] this->trees[i].distance_frombase;
+		delete[] this->trees[i].predecessor;
+	}
+	delete this->queue;
+	delete[] this->affected_stamp;
+}
+
+//////////////////////////////////////PUBLIC METHODS////////////////////////////////////////////////////////////////
+
+// the first tree is a full Dijkstra search, its predecessors are the tree edges
+int dynamic_shortest_paths::add_source(unsigned int source_vortex)
+{
+	if (this->graph->find_vortex(source_vortex) == nullptr)
+		return -1;
+	reserve(this->graph->get_vortex_index_range());
+	search_context context(this->capacity);
+	dijkstra_all_distances(*this->graph, context, source_vortex);
+
+	source_tree tree;
+	tree.source_vortex = source_vortex;
+	tree.distance_frombase = new int[this->capacity];
+	tree.predecessor = new unsigned int[this->capacity];
+	for (unsigned int i = 0; i < this->capacity; ++i)
+	{
+		tree.distance_frombase[i] = i < this->graph->get_vortex_index_range() ? context.get_distance(i) : UNREACHED_DISTANCE;
+		tree.predecessor[i] = i < this->graph->get_vortex_index_range() ? context.get_predecessor(i) : NO_PREDECESSOR;
+	}
+	this->trees.push_back(tree);
+	return (int)(this->trees.size() - 1);
+}
+
+unsigned int dynamic_shortest_paths::get_source_number() const
+{
+	return (unsigned int)this->trees.size();
+}
+
+int dynamic_shortest_paths::get_distance(unsigned int source, unsigned int vortex_index) const
+{
+	if (source >= this->trees.size() || vortex_index >= this->capacity || this->trees[source].distance_frombase[vortex_index] == UNREACHED_DISTANCE)
+		return -1;
+	return this->trees[source].distance_frombase[vortex_index];
+}
+
+unsigned int dynamic_shortest_paths::get_predecessor(unsigned int source, unsigned int vortex_index) const
+{
+	if (source >= this->trees.size() || vortex_index >= this->capacity)
+		return NO_PREDECESSOR;
+	return this->trees[source].predecessor[vortex_index];
+}
+
+int dynamic_shortest_paths::add_edge(unsigned int vortex1, unsigned int vortex2, unsigned int weight)
+{
+	int result = this->graph->add_edge(vortex1, vortex2, weight);
+	if (result >= 0)
+		edge_updated(vortex1, vortex2);
+	return result;
+}
+
+int dynamic_shortest_paths::remove_edge(unsigned int vortex1, unsigned int vortex2)
+{
+	int result = this->graph->remove_edge(vortex1, vortex2);
+	if (result >= 0)
+		edge_updated(vortex1, vortex2);
+	return result;
+}
+
+int dynamic_shortest_paths::add_vortex(unsigned int vortex_index)
+{
+	int result = this->graph->add_vortex(vortex_index);
+	reserve(this->graph->get_vortex_index_range());
+	this->last_repair_size = 0;
+	for (unsigned long long i = 0; i < this->trees.size(); ++i)
+	{
+		restore_source(this->trees[i]);
+		propagate(this->trees[i]);
+	}
+	return result;
+}
+
+// the neighbors are read before the vortex goes, they are the only way to find its children in the trees
+int dynamic_shortest_paths::remove_vortex(unsigned int vortex_index)
+{
+	if (this->graph->find_vortex(vortex_index) == nullptr)
+		return this->graph->remove_vortex(vortex_index);
+	dynamic_array<unsigned int> neighbors;
+	this->graph->for_each_neighbor(vortex_index, [&](unsigned int neighbor, unsigned int) { neighbors.push_back(neighbor); });
+	int result = this->graph->remove_vortex(vortex_index);
+
+	this->last_repair_size = 0;
+	for (unsigned long long i = 0; i < this->trees.size(); ++i)
+	{
+		source_tree &tree = this->trees[i];
+		if (tree.distance_frombase[vortex_index] == UNREACHED_DISTANCE)
+			continue;
+		begin_affected_region();
+		if (tree.source_vortex == vortex_index)
+		{ // every reached vortex goes, and none can be reached again
+			for (unsigned int j = 0; j < this->capacity; ++j)
+			{
+				if (tree.distance_frombase[j] != UNREACHED_DISTANCE)
+					++this->last_repair_size;
+				tree.distance_frombase[j] = UNREACHED_DISTANCE;
+				tree.predecessor[j] = NO_PREDECESSOR;
+			}
+			continue;
+		}
+		tree.distance_frombase[vortex_index] = UNREACHED_DISTANCE;
+		tree.predecessor[vortex_index] = NO_PREDECESSOR;
+		for (unsigned long long j = 0; j < neighbors.size(); ++j)
+		{
+			if (tree.predecessor[neighbors[j]] == vortex_index)
+				this->affected.push_back(neighbors[j]);
+		}
+		collect_affected_subtree(tree);
+		seed_affected_subtree(tree);
+		propagate(tree);
+	}
+	return result;
+}
+
+// the current weight is read from the graph, so the same repair covers insertions, removals and weight changes
+void dynamic_shortest_paths::edge_updated(unsigned int vortex1, unsigned int vortex2)
+{
+	reserve(this->graph->get_vortex_index_range());
+	this->last_repair_size = 0;
+	if (vortex1 >= this->capacity || vortex2 >= this->capacity || vortex1 == vortex2)
+		return;
+	int edge_weight = this->graph->get_edge_weight(vortex1, vortex2);
+	for (unsigned long long i = 0; i < this->trees.size(); ++i)
+		repair_edge(this->trees[i], vortex1, vortex2, edge_weight);
+}
+
+unsigned long long dynamic_shortest_paths::get_last_repair_size() const
+{
+	return this->last_repair_size;
+}
+
+//////////////////////////////////////PRIVATE METHODS///////////////////////////////////////////////////////////////
+
+// reallocates every array with room to spare, so adding vortexes one by one costs amortized constant time
+void dynamic_shortest_paths::reserve(unsigned int new_capacity)
+{
+	if (new_capacity <= this->capacity && this->queue != nullptr)
+		return;
+	if (new_capacity < 2 * this->capacity)
+		new_capacity = 2 * this->capacity;
+	for (unsigned long long i = 0; i < this->trees.size(); ++i)
+	{
+		source_tree &tree = this->trees[i];
+		int *distance_frombase = new int[new_capacity];
+		unsigned int *predecessor = new unsigned int[new_capacity];
+		for (unsigned int j = 0; j < new_capacity; ++j)
+		{
+			distance_frombase[j] = j < this->capacity ? tree.distance_frombase[j] : UNREACHED_DISTANCE;
+			predecessor[j] = j < this->capacity ? tree.predecessor[j] : NO_PREDECESSOR;
+		}
+		delete[] tree.distance_frombase;
+		delete[] tree.predecessor;
+		tree.distance_frombase = distance_frombase;
+		tree.predecessor = predecessor;
+	}
+	delete this->queue;
+	delete[] this->affected_stamp;
+	this->queue = new dary_heap<int>(new_capacity);
+	this->affected_stamp = new unsigned int[new_capacity]();
+	this->repair_stamp = 0;
+	this->capacity = new_capacity;
+}
+
+void dynamic_shortest_paths::restore_source(source_tree &tree)
+{
+	if (tree.distance_frombase[tree.source_vortex] == 0 || this->graph->find_vortex(tree.source_vortex) == nullptr)
+		return;
+	tree.distance_frombase[tree.source_vortex] = 0;
+	tree.predecessor[tree.source_vortex] = NO_PREDECESSOR;
+	this->queue->push(tree.source_vortex, 0);
+	++this->last_repair_size;
+}
+
+// empties the affected region, resetting the stamps when they wrap around
+void dynamic_shortest_paths::begin_affected_region()
+{
+	this->affected.clear();
+	if (++this->repair_stamp == 0)
+	{
+		memset(this->affected_stamp, 0, this->capacity * sizeof(unsigned int));
+		this->repair_stamp = 1;
+	}
+}
+
+// walks the tree down from the vortexes of the region: a neighbor whose predecessor is a vortex of the region
+// is its child, so the walk costs the edges of the region only
+void dynamic_shortest_paths::collect_affected_subtree(source_tree &tree)
+{
+	for (unsigned long long i = 0; i < this->affected.size(); ++i)
+		this->affected_stamp[this->affected[i]] = this->repair_stamp;
+	for (unsigned long long i = 0; i < this->affected.size(); ++i)
+	{
+		unsigned int current_node = this->affected[i];
+		this->graph->for_each_neighbor(current_node, [&](unsigned int neighbor, unsigned int) {
+			if (tree.predecessor[neighbor] == current_node && this->affected_stamp[neighbor] != this->repair_stamp)
+			{
+				this->affected_stamp[neighbor] = this->repair_stamp;
+				this->affected.push_back(neighbor);
+			}
+		});
+	}
+	for (unsigned long long i = 0; i < this->affected.size(); ++i)
+	{
+		tree.distance_frombase[this->affected[i]] = UNREACHED_DISTANCE;
+		tree.predecessor[this->affected[i]] = NO_PREDECESSOR;
+	}
+	this->last_repair_size += this->affected.size();
+}
+
+void dynamic_shortest_paths::seed_affected_subtree(source_tree &tree)
+{
+	for (unsigned long long i = 0; i < this->affected.size(); ++i)
+	{
+		unsigned int current_node = this->affected[i];
+		this->graph->for_each_neighbor(current_node, [&](unsigned int neighbor, unsigned int edge_weight) {
+			if (this->affected_stamp[neighbor] != this->repair_stamp)
+				relax_edge(tree, neighbor, current_node, edge_weight);
+		});
+	}
+}
+
+void dynamic_shortest_paths::relax_edge(source_tree &tree, unsigned int vortex_from, unsigned int vortex_to, unsigned int edge_weight)
+{
+	if (tree.distance_frombase[vortex_from] == UNREACHED_DISTANCE)
+		return;
+	int new_distance = tree.distance_frombase[vortex_from] + (int)edge_weight;
+	if (new_distance < tree.distance_frombase[vortex_to])
+	{
+		tree.distance_frombase[vortex_to] = new_distance;
+		tree.predecessor[vortex_to] = vortex_from;
+		this->queue->push(vortex_to, new_distance);
+	}
+}
+
+// only strictly shorter distances are spread, so the search stops at the border of the changed region
+void dynamic_shortest_paths::propagate(source_tree &tree)
+{
+	unsigned int current_node;
+	int current_distance;
+	while (!this->queue->empty())
+	{
+		this->queue->pop(current_node, current_distance);
+		++this->last_repair_size;
+		this->graph->for_each_neighbor(current_node, [&](unsigned int neighbor, unsigned int edge_weight) {
+			relax_edge(tree, current_node, neighbor, edge_weight);
+		});
+	}
+}
+
+// a longer or removed tree edge clears and reseeds the subtree of its lower end, then a shorter or new edge
+// relaxes both directions, and the queued vortexes are spread
+void dynamic_shortest_paths::repair_edge(source_tree &tree, unsigned int vortex1, unsigned int vortex2, int edge_weight)
+{
+	restore_source(tree);
+	unsigned int child = NO_PREDECESSOR;
+	if (tree.predecessor[vortex2] == vortex1 && (edge_weight < 0 || tree.distance_frombase[vortex1] + edge_weight > tree.distance_frombase[vortex2]))
+		child = vortex2;
+	else if (tree.predecessor[vortex1] == vortex2 && (edge_weight < 0 || tree.distance_frombase[vortex2] + edge_weight > tree.distance_frombase[vortex1]))
+		child = vortex1;
+	if (child != NO_PREDECESSOR)
+	{
+		begin_affected_region();
+		this->affected.push_back(child);
+		collect_affected_subtree(tree);
+		seed_affected_subtree(tree);
+	}
+	if (edge_weight >= 0)
+	{
+		relax_edge(tree, vortex1, vortex2, edge_weight);
+		relax_edge(tree, vortex2, vortex1, edge_weight);
+	}
+	propagate(tree);
+}
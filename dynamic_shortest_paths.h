@@ -0,0 +1,177 @@
+#ifndef DYNAMIC_SHORTEST_PATHS_H
+#define DYNAMIC_SHORTEST_PATHS_H
+
+/**
+ * @file dynamic_shortest_paths.h
+ * @brief Shortest path trees of a few registered sources, kept up to date under edge insertions, removals and weight changes.
+ *
+ * @author Fernando Elena Benavente
+ *
+ * Every source keeps its distance and predecessor arrays, the shortest path tree, built once with a full Dijkstra search. After an edge update only the vortexes whose distance changes are visited again, as in the dynamic algorithm of Ramalingam and Reps:
+ * - An inserted edge or a lowered weight can only shorten paths. If it shortens the path to one of its ends, that end is queued and a Dijkstra search spreads the new distances from it, stopping where they are no shorter than the old ones.
+ * - A removed edge or a raised weight only matters when it is an edge of the tree. Then the subtree under it is the affected region: its vortexes are found by following the predecessor links down from the lower end, their distances are cleared, every one of them gets the best distance through a neighbor outside the region, and a Dijkstra search restricted to the region settles the rest.
+ *
+ * Both cost a few times the edges of the vortexes whose distance or predecessor changes, not the size of the graph, as long as the neighbors of a vortex are local: with lower index storage for_each_neighbor() scans the lower index vortexes, so the graph should use symmetric storage.
+ *
+ * The object keeps a pointer to the graph. Updates go through add_edge(), remove_edge(), add_vortex() and remove_vortex() of this class, which change the graph and repair the trees; an edge changed directly on the graph is repaired by calling edge_updated() right after.
+ */
+
+#include <limits>
+
+#include "dynamic_array.h"
+#include "graph.h"
+#include "vortex_queue.h"
+
+/**
+ * @class dynamic_shortest_paths
+ * @brief Incrementally maintained shortest path trees from registered sources of a list_graph.
+ */
+class dynamic_shortest_paths
+{
+public:
+    static const unsigned int NO_PREDECESSOR = std::numeric_limits<unsigned int>::max(); /**< Predecessor of the sources and of unreachable vortexes. */
+
+    /**
+     * @brief Creates an object with no sources for a graph.
+     *
+     * @param graph The graph, changed by the update methods of this object.
+     */
+    dynamic_shortest_paths(list_graph &graph);
+
+    /**
+     * @brief Destructor that frees the trees.
+     */
+    ~dynamic_shortest_paths();
+
+    dynamic_shortest_paths(const dynamic_shortest_paths &) = delete;
+    dynamic_shortest_paths &operator=(const dynamic_shortest_paths &) = delete;
+
+    /**
+     * @brief Registers a source and builds its shortest path tree with a full Dijkstra search.
+     *
+     * @param source_vortex The index of the source vortex.
+     *
+     * @return The number of the source, used by the queries, or -1 if the vortex does not exist.
+     */
+    int add_source(unsigned int source_vortex);
+
+    /**
+     * @brief Returns the number of registered sources.
+     */
+    unsigned int get_source_number() const;
+
+    /**
+     * @brief Returns the shortest distance from a source to a vortex.
+     *
+     * @param source The number returned by add_source().
+     * @param vortex_index The index of the vortex.
+     *
+     * @return The distance, or -1 if the vortex is not reachable from the source or does not exist.
+     */
+    int get_distance(unsigned int source, unsigned int vortex_index) const;
+
+    /**
+     * @brief Returns the previous vortex on the shortest path from a source to a vortex, NO_PREDECESSOR for the source and unreachable vortexes.
+     */
+    unsigned int get_predecessor(unsigned int source, unsigned int vortex_index) const;
+
+    /**
+     * @brief Adds an edge or changes its weight through list_graph::add_edge(), and repairs the trees.
+     *
+     * @return The result of list_graph::add_edge().
+     */
+    int add_edge(unsigned int vortex1, unsigned int vortex2, unsigned int weight);
+
+    /**
+     * @brief Removes an edge through list_graph::remove_edge(), and repairs the trees.
+     *
+     * @return The result of list_graph::remove_edge().
+     */
+    int remove_edge(unsigned int vortex1, unsigned int vortex2);
+
+    /**
+     * @brief Adds a vortex through list_graph::add_vortex(), a source with that index gets back its zero distance.
+     *
+     * @return The result of list_graph::add_vortex().
+     */
+    int add_vortex(unsigned int vortex_index);
+
+    /**
+     * @brief Removes a vortex and its edges through list_graph::remove_vortex(), and repairs the trees. A source with that index reaches nothing until the vortex is added again.
+     *
+     * @return The result of list_graph::remove_vortex().
+     */
+    int remove_vortex(unsigned int vortex_index);
+
+    /**
+     * @brief Repairs the trees after the edge between two vortexes was added, removed or changed directly on the graph.
+     *
+     * @param vortex1 The index of the first vortex.
+     * @param vortex2 The index of the second vortex.
+     */
+    void edge_updated(unsigned int vortex1, unsigned int vortex2);
+
+    /**
+     * @brief Returns the number of distances recomputed by the last update over every tree, the work it did.
+     */
+    unsigned long long get_last_repair_size() const;
+
+private:
+    struct source_tree
+    {
+        unsigned int source_vortex;  /**< Index of the source. */
+        int *distance_frombase;      /**< Distance from the source, numeric_limits<int>::max() if unreachable. */
+        unsigned int *predecessor;   /**< Parent in the shortest path tree, NO_PREDECESSOR for the source and unreachable vortexes. */
+    };
+
+    list_graph *graph;                    /**< The graph the trees belong to. */
+    dynamic_array<source_tree> trees;     /**< Tree of every registered source. */
+    unsigned int capacity;                /**< Vortex indexes covered by the arrays. */
+    dary_heap<int> *queue;                /**< Heap of the repair searches, empty between updates. */
+    unsigned int *affected_stamp;         /**< Equal to repair_stamp on the vortexes of the current affected region. */
+    unsigned int repair_stamp;            /**< Stamp of the current affected region. */
+    dynamic_array<unsigned int> affected; /**< Vortexes of the current affected region. */
+    unsigned long long last_repair_size;  /**< Distances recomputed by the last update. */
+
+    /**
+     * @brief Grows the arrays of every tree and the working arrays to the index range of the graph, new vortexes are unreachable.
+     */
+    void reserve(unsigned int new_capacity);
+
+    /**
+     * @brief Gives back the zero distance to the source of a tree if its vortex exists and lost it, and queues it.
+     */
+    void restore_source(source_tree &tree);
+
+    /**
+     * @brief Empties the affected region and takes a new stamp for it.
+     */
+    void begin_affected_region();
+
+    /**
+     * @brief Extends the affected region, the vortexes of affected, with all their descendants in the tree, and clears their distances.
+     */
+    void collect_affected_subtree(source_tree &tree);
+
+    /**
+     * @brief Gives every vortex of the affected region its best distance through a neighbor outside the region, and queues it.
+     */
+    void seed_affected_subtree(source_tree &tree);
+
+    /**
+     * @brief Lowers the distance of vortex_to through the edge from vortex_from if it is shorter, and queues it.
+     */
+    void relax_edge(source_tree &tree, unsigned int vortex_from, unsigned int vortex_to, unsigned int edge_weight);
+
+    /**
+     * @brief Runs Dijkstra's search from the queued vortexes, spreading the shorter distances.
+     */
+    void propagate(source_tree &tree);
+
+    /**
+     * @brief Repairs a tree after the edge between two vortexes became edge_weight, or was removed if edge_weight is -1.
+     */
+    void repair_edge(source_tree &tree, unsigned int vortex1, unsigned int vortex2, int edge_weight);
+};
+
+#endif
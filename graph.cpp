@@ -1,18 +1,37 @@
+#include <cmath>
+#include <thread>
+
 #include "graph.h"
+#include "alt_landmarks.h"
+#include "compressed_graph.h"
+#include "graph_search.h"
+#include "dynamic_array.h"
 
 // Constructor implementation
-list_graph::list_graph(int vortex_number, string graph_name)
+list_graph::list_graph(int vortex_number, string graph_name, bool symmetric_storage)
 {
 	this->vortex_number = vortex_number;
 	this->graph_name = graph_name;
+	this->symmetric_storage = symmetric_storage;
 	this->graph_head = nullptr;
+	this->max_edge_weight = 0;
+	this->shortening_version = 0;
+	this->component_parent = nullptr;
+	this->component_size = nullptr;
+	this->component_capacity = 0;
+	this->component_index_valid = false;
+	this->query_snapshot = nullptr;
+	this->vortex_table_capacity = vortex_number > 0 ? vortex_number : 0;
+	this->vortex_index_range = this->vortex_table_capacity;
+	this->vortex_table = new vortex *[this->vortex_table_capacity];
+	this->vortex_pool.reserve(this->vortex_table_capacity); // every initial vortex in one slab
 	vortex *current_vortex, *previous_vortex;
 
 	for (int i = 0; i < this->vortex_number; ++i)
 	{ // generate the graph with the vortex number we indicated
 		if (i == 0)
 		{
-			current_vortex = new vortex;
+			current_vortex = vortex_pool.allocate();
 			graph_head = current_vortex;
 			graph_head->next = nullptr;
 			graph_head->edge_ptr = nullptr;
@@ -21,44 +40,62 @@ list_graph::list_graph(int vortex_number, string graph_name)
 		else
 		{
 			previous_vortex = current_vortex;
-			current_vortex = new vortex;
+			current_vortex = vortex_pool.allocate();
 			previous_vortex->next = current_vortex;
 			current_vortex->next = nullptr;
 			current_vortex->edge_ptr = nullptr;
 			current_vortex->vortex_index = i;
 		}
+		vortex_table[i] = current_vortex;
 	}
 }
 
-// Destructor implementation
+// Destructor implementation, edges and vortexes are released in bulk when their pools are destroyed
 list_graph::~list_graph()
 {
-	vortex *current_vortex = graph_head;
-	while (current_vortex != nullptr)
-	{
-		edge *current_edge = current_vortex->edge_ptr;
-		while (current_edge != nullptr)
-		{
-			edge *next_edge = current_edge->next;
-			delete current_edge;
-			current_edge = next_edge;
-		}
-		vortex *next_vortex = current_vortex->next;
-		delete current_vortex;
-		current_vortex = next_vortex;
-	}
+	delete[] vortex_table;
+	delete[] component_parent;
+	delete[] component_size;
+	delete query_snapshot;
 }
 
 //////////////////////////////////////PRIVATE METHODS////////////////////////////////////////////////////////////////
 
+// constant time lookup of a vortex in the index table
+vortex *list_graph::find_vortex(unsigned int vortex_index) const
+{
+	if (vortex_index >= this->vortex_index_range)
+		return nullptr;
+	return this->vortex_table[vortex_index];
+}
+
+// reallocates the vortex index with at least min_capacity slots, new slots are empty
+void list_graph::grow_vortex_table(unsigned int min_capacity)
+{
+	if (min_capacity <= this->vortex_table_capacity)
+		return;
+	unsigned int new_capacity = this->vortex_table_capacity * 2;
+	if (new_capacity < min_capacity)
+		new_capacity = min_capacity;
+
+	vortex **new_table = new vortex *[new_capacity];
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+		new_table[i] = this->vortex_table[i];
+	delete[] this->vortex_table;
+	this->vortex_table = new_table;
+	this->vortex_table_capacity = new_capacity;
+}
+
 // ads an edge between 2 vortexs with a weight
 void list_graph::add_edge_private(vortex &Vortex, unsigned int vortex_index_to, unsigned int edge_weight)
 {
 	// Create a new edge
-	edge *new_edge = new edge;
+	edge *new_edge = edge_pool.allocate();
 	new_edge->vortex_index = vortex_index_to;
 	new_edge->edge_weight = edge_weight;
 	new_edge->next = nullptr;
+	if (edge_weight > this->max_edge_weight)
+		this->max_edge_weight = edge_weight;
 
 	// If the vortex has no edges, simply add the new edge
 	if (Vortex.edge_ptr == nullptr)
@@ -91,6 +128,223 @@ void list_graph::add_edge_private(vortex &Vortex, unsigned int vortex_index_to,
 	}
 }
 
+// appends an edge after the tail of the list if it goes last, otherwise inserts it sorted or updates its weight
+void list_graph::append_edge_private(vortex &Vortex, edge *&tail, unsigned int vortex_index_to, unsigned int edge_weight, node_pool<edge> &pool)
+{
+	if (tail == nullptr || tail->vortex_index < vortex_index_to)
+	{
+		edge *new_edge = pool.allocate();
+		new_edge->vortex_index = vortex_index_to;
+		new_edge->edge_weight = edge_weight;
+		new_edge->next = nullptr;
+
+		if (tail == nullptr)
+			Vortex.edge_ptr = new_edge;
+		else
+			tail->next = new_edge;
+		tail = new_edge;
+		return;
+	}
+
+	edge *current_edge = Vortex.edge_ptr;
+	edge *previous_edge = nullptr;
+	while (current_edge->vortex_index < vortex_index_to)
+	{ // the tail index is bigger, so the walk stops before the end of the list
+		previous_edge = current_edge;
+		current_edge = current_edge->next;
+	}
+	if (current_edge->vortex_index == vortex_index_to)
+	{ // if edge already exists, update the weight
+		current_edge->edge_weight = edge_weight;
+		return;
+	}
+
+	edge *new_edge = pool.allocate();
+	new_edge->vortex_index = vortex_index_to;
+	new_edge->edge_weight = edge_weight;
+	new_edge->next = current_edge;
+	if (previous_edge == nullptr)
+		Vortex.edge_ptr = new_edge;
+	else
+		previous_edge->next = new_edge;
+}
+
+// adds or updates a generated edge on the lists of both vortexes, appending when it goes last
+void list_graph::append_generated_edge(unsigned int low_vortex, unsigned int high_vortex, unsigned int weight, edge **tails)
+{
+	append_edge_private(*this->vortex_table[low_vortex], tails[low_vortex], high_vortex, weight, this->edge_pool);
+	if (this->symmetric_storage)
+		append_edge_private(*this->vortex_table[high_vortex], tails[high_vortex], low_vortex, weight, this->edge_pool);
+	if (weight > this->max_edge_weight)
+		this->max_edge_weight = weight;
+	++this->shortening_version;
+	if (this->component_index_valid)
+		union_components(low_vortex, high_vortex);
+}
+
+// finds the last edge of every adjacency list
+edge **list_graph::collect_edge_tails() const
+{
+	edge **tails = new edge *[this->vortex_index_range]();
+	for (vortex *current_vortex = this->graph_head; current_vortex != nullptr; current_vortex = current_vortex->next)
+	{
+		for (edge *current_edge = current_vortex->edge_ptr; current_edge != nullptr; current_edge = current_edge->next)
+			tails[current_vortex->vortex_index] = current_edge;
+	}
+	return tails;
+}
+
+// appends the vortexes of the new indexes after the highest existing one, the vortex list stays sorted
+void list_graph::extend_vortex_range(unsigned int new_range)
+{
+	if (new_range <= this->vortex_index_range)
+		return;
+	grow_vortex_table(new_range);
+	this->vortex_pool.reserve(new_range - this->vortex_index_range);
+
+	vortex *last_vortex = this->vortex_index_range > 0 ? this->vortex_table[this->vortex_index_range - 1] : nullptr;
+	for (unsigned int i = this->vortex_index_range; i < new_range; ++i)
+	{
+		vortex *new_vortex = vortex_pool.allocate();
+		new_vortex->vortex_index = i;
+		new_vortex->edge_ptr = nullptr;
+		new_vortex->next = nullptr;
+		if (last_vortex == nullptr)
+			graph_head = new_vortex;
+		else
+			last_vortex->next = new_vortex;
+		last_vortex = new_vortex;
+		this->vortex_table[i] = new_vortex;
+		if (i < this->component_capacity)
+		{ // a vortex without edges is its own component
+			this->component_parent[i] = i;
+			this->component_size[i] = 1;
+		}
+	}
+	if (new_range > this->component_capacity)
+		this->component_index_valid = false;
+	this->vortex_number += new_range - this->vortex_index_range;
+	this->vortex_index_range = new_range;
+}
+
+// LSD radix sort of half edges by (from_vortex, to_vortex), one byte of the 64 bit key per pass, stable so
+// repeated edges keep their insertion order. The byte histograms of every pass are counted in a single read,
+// and passes where every key has the same byte are skipped, so small graphs only pay for the bytes in use.
+static void radix_sort_half_edges(generated_half_edge *half_edges, unsigned long long half_edge_number)
+{
+	if (half_edge_number < 2)
+		return;
+	auto key_byte = [](const generated_half_edge &half_edge, unsigned int pass) {
+		return pass < 4 ? (half_edge.to_vortex >> (8 * pass)) & 255 : (half_edge.from_vortex >> (8 * (pass - 4))) & 255;
+	};
+
+	unsigned long long (*byte_count)[256] = new unsigned long long[8][256]();
+	for (unsigned long long i = 0; i < half_edge_number; ++i)
+		for (unsigned int pass = 0; pass < 8; ++pass)
+			++byte_count[pass][key_byte(half_edges[i], pass)];
+
+	generated_half_edge *source = half_edges;
+	generated_half_edge *target = new generated_half_edge[half_edge_number];
+	generated_half_edge *buffer = target;
+	for (unsigned int pass = 0; pass < 8; ++pass)
+	{
+		if (byte_count[pass][key_byte(source[0], pass)] == half_edge_number)
+			continue; // every key has the same byte, the order does not change
+		unsigned long long position = 0;
+		for (unsigned int digit = 0; digit < 256; ++digit)
+		{ // counts become the first position of every byte value
+			unsigned long long digit_count = byte_count[pass][digit];
+			byte_count[pass][digit] = position;
+			position += digit_count;
+		}
+		for (unsigned long long i = 0; i < half_edge_number; ++i)
+			target[byte_count[pass][key_byte(source[i], pass)]++] = source[i];
+		generated_half_edge *sorted = target;
+		target = source;
+		source = sorted;
+	}
+	if (source != half_edges)
+		memcpy(half_edges, source, half_edge_number * sizeof(generated_half_edge));
+	delete[] buffer;
+	delete[] byte_count;
+}
+
+// radix sorts the batch, keeps the last copy of every repeated edge, and merges the lists; with symmetric
+// storage the reversed half edges are sorted and merged in a second pass
+unsigned long long list_graph::merge_edge_batch(generated_half_edge *edges, unsigned long long edge_number)
+{
+	radix_sort_half_edges(edges, edge_number);
+
+	unsigned long long unique_number = 0;
+	for (unsigned long long i = 0; i < edge_number; ++i)
+	{
+		if (i + 1 < edge_number && edges[i + 1].from_vortex == edges[i].from_vortex && edges[i + 1].to_vortex == edges[i].to_vortex)
+			continue; // a later copy of the same edge overrides this one
+		edges[unique_number++] = edges[i];
+	}
+
+	merge_sorted_half_edges(edges, unique_number);
+	if (this->symmetric_storage)
+	{
+		generated_half_edge *reversed_edges = new generated_half_edge[unique_number];
+		for (unsigned long long i = 0; i < unique_number; ++i)
+			reversed_edges[i] = {edges[i].to_vortex, edges[i].from_vortex, edges[i].edge_weight};
+		radix_sort_half_edges(reversed_edges, unique_number);
+		merge_sorted_half_edges(reversed_edges, unique_number);
+		delete[] reversed_edges;
+	}
+	if (unique_number > 0)
+		++this->shortening_version;
+
+	for (unsigned long long i = 0; i < unique_number; ++i)
+	{
+		if (edges[i].edge_weight > this->max_edge_weight)
+			this->max_edge_weight = edges[i].edge_weight;
+		if (this->component_index_valid)
+			union_components(edges[i].from_vortex, edges[i].to_vortex);
+	}
+	return unique_number;
+}
+
+// walks each receiving list once, next to its run of the batch: existing edges get the new weight, and the
+// rest are linked in front of the first bigger index
+void list_graph::merge_sorted_half_edges(const generated_half_edge *half_edges, unsigned long long half_edge_number)
+{
+	unsigned long long i = 0;
+	while (i < half_edge_number)
+	{
+		unsigned int from_vortex = half_edges[i].from_vortex;
+		vortex *current_vortex = this->vortex_table[from_vortex];
+		edge *previous_edge = nullptr;
+		edge *current_edge = current_vortex->edge_ptr;
+
+		for (; i < half_edge_number && half_edges[i].from_vortex == from_vortex; ++i)
+		{
+			unsigned int vortex_index_to = half_edges[i].to_vortex;
+			while (current_edge != nullptr && current_edge->vortex_index < vortex_index_to)
+			{
+				previous_edge = current_edge;
+				current_edge = current_edge->next;
+			}
+			if (current_edge != nullptr && current_edge->vortex_index == vortex_index_to)
+			{ // if edge already exists, update the weight
+				current_edge->edge_weight = half_edges[i].edge_weight;
+				continue;
+			}
+
+			edge *new_edge = edge_pool.allocate();
+			new_edge->vortex_index = vortex_index_to;
+			new_edge->edge_weight = half_edges[i].edge_weight;
+			new_edge->next = current_edge;
+			if (previous_edge == nullptr)
+				current_vortex->edge_ptr = new_edge;
+			else
+				previous_edge->next = new_edge;
+			previous_edge = new_edge;
+		}
+	}
+}
+
 void list_graph::remove_edge_private(vortex &Vortex, unsigned int vortex_index_to)
 {
 	edge *current_edge = Vortex.edge_ptr;
@@ -116,81 +370,63 @@ void list_graph::remove_edge_private(vortex &Vortex, unsigned int vortex_index_t
 		previous_edge->next = current_edge->next;
 	}
 
-	// Delete the current edge
-	delete current_edge;
+	// Give the current edge back to the pool
+	edge_pool.release(current_edge);
 }
 
-// finds the reachable nodes from a base node in the current graph, expects an array initialized with -1, uses backtracking algorithm
-void list_graph::full_reachable_vortexs(int *ptr, unsigned int base_node)
+// builds the union-find index of connected components, one union per edge, linear time
+void list_graph::build_component_index()
 {
-	if (ptr[base_node] == -1) // if node is still not reached, setup as reached node
-		ptr[base_node] = 0;
-	else
-		return;
+	if (this->component_capacity < this->vortex_index_range)
+	{
+		delete[] this->component_parent;
+		delete[] this->component_size;
+		this->component_capacity = this->vortex_index_range;
+		this->component_parent = new unsigned int[this->component_capacity];
+		this->component_size = new unsigned int[this->component_capacity];
+	}
+	for (unsigned int i = 0; i < this->component_capacity; ++i)
+	{
+		this->component_parent[i] = i;
+		this->component_size[i] = 1;
+	}
 
-	vortex *current_vortex = this->graph_head;
-	edge *current_edge;
-	for (int i = 0; i <= base_node; ++i)
+	for (vortex *current_vortex = graph_head; current_vortex != nullptr; current_vortex = current_vortex->next)
 	{
-		current_edge = current_vortex->edge_ptr;
-		while (current_edge != nullptr)
+		for (edge *current_edge = current_vortex->edge_ptr; current_edge != nullptr; current_edge = current_edge->next)
 		{
-			if (ptr[current_edge->vortex_index] == -1 && ptr[current_vortex->vortex_index] == 0)
-			{
-				full_reachable_vortexs(ptr, current_edge->vortex_index);
-			}
-			if (ptr[current_edge->vortex_index] == 0 && ptr[current_vortex->vortex_index] == -1)
-			{
-				full_reachable_vortexs(ptr, current_vortex->vortex_index);
-			}
-			current_edge = current_edge->next;
+			union_components(current_vortex->vortex_index, current_edge->vortex_index);
 		}
-		current_vortex = current_vortex->next;
 	}
+	this->component_index_valid = true;
 }
 
-// receives a current node, the distance to that node from base, an and array of distances, used mainly for dijkstra algorithm
-// the distance array is suposed to be initialized already , with -1 representing infinite
-void list_graph::reach_vortex(unsigned int current_node, unsigned int current_distance_frombase, int *distance_array)
+// returns the component representative of a vortex, with path halving
+unsigned int list_graph::find_component(unsigned int vortex_index)
 {
-	vortex *current_vortex = this->graph_head;
-	edge *current_edge;
-	for (int i = 0; i <= current_node; i++)
+	while (this->component_parent[vortex_index] != vortex_index)
 	{
-		current_edge = current_vortex->edge_ptr;
-		while (current_edge != nullptr)
-		{
-			if (current_vortex->vortex_index != current_node && current_edge->vortex_index == current_node)
-			{
-				if (current_distance_frombase + current_edge->edge_weight < distance_array[current_vortex->vortex_index] || distance_array[current_vortex->vortex_index] == -1)
-				{
-					distance_array[current_vortex->vortex_index] = current_distance_frombase + current_edge->edge_weight;
-				}
-			}
-			else if (current_vortex->vortex_index == current_node)
-			{
-				if (current_distance_frombase + current_edge->edge_weight < distance_array[current_edge->vortex_index] || distance_array[current_edge->vortex_index] == -1)
-				{
-					distance_array[current_edge->vortex_index] = current_distance_frombase + current_edge->edge_weight;
-				}
-			}
-			current_edge = current_edge->next;
-		}
-		current_vortex = current_vortex->next;
+		this->component_parent[vortex_index] = this->component_parent[this->component_parent[vortex_index]];
+		vortex_index = this->component_parent[vortex_index];
 	}
+	return vortex_index;
 }
 
-// checks if every vortex is visted, from an already initiatied vortex array
-int list_graph::check_all_vortex_visited(int *visited_vortex)
+// joins the components of two vortexes, union by size
+void list_graph::union_components(unsigned int vortex1, unsigned int vortex2)
 {
-	for (int i = 0; i < this->vortex_number; i++)
+	vortex1 = find_component(vortex1);
+	vortex2 = find_component(vortex2);
+	if (vortex1 == vortex2)
+		return;
+	if (this->component_size[vortex1] < this->component_size[vortex2])
 	{
-		if (visited_vortex[i] == 0)
-		{
-			return 0;
-		}
+		unsigned int temp = vortex1;
+		vortex1 = vortex2;
+		vortex2 = temp;
 	}
-	return 1;
+	this->component_parent[vortex2] = vortex1;
+	this->component_size[vortex1] += this->component_size[vortex2];
 }
 
 //////////////////////////////////////PUBLIC METHODS////////////////////////////////////////////////////////////////
@@ -207,14 +443,18 @@ void list_graph::print_graph_edges()
 {
 	vortex *iterator_vortex = graph_head;
 	edge *iterator_edge;
-	for (int i = 0; i < this->vortex_number; ++i)
+	while (iterator_vortex != nullptr)
 	{
 		iterator_edge = iterator_vortex->edge_ptr;
 		do
 		{
-			if (iterator_edge != nullptr)
+			if (iterator_edge != nullptr && iterator_edge->vortex_index < iterator_vortex->vortex_index)
 			{
-				cout << "Edge between " << i << " and " << iterator_edge->vortex_index << " with weight: " << iterator_edge->edge_weight << endl;
+				iterator_edge = iterator_edge->next; // symmetric storage, the edge is printed from the lower index vortex
+			}
+			else if (iterator_edge != nullptr)
+			{
+				cout << "Edge between " << iterator_vortex->vortex_index << " and " << iterator_edge->vortex_index << " with weight: " << iterator_edge->edge_weight << endl;
 				iterator_edge = iterator_edge->next;
 			}
 		} while (iterator_edge != nullptr);
@@ -225,38 +465,56 @@ void list_graph::print_graph_edges()
 // Function to add a vortex (vertex) to the graph in a sorted order
 int list_graph::add_vortex(unsigned int vortex_index)
 {
+	release_query_snapshot();
 	// Check if the vertex already exists
-	vortex *temp = graph_head;
-	while (temp != nullptr)
+	if (find_vortex(vortex_index) != nullptr)
 	{
-		if (temp->vortex_index == vortex_index)
-		{
-			return -1; // Vertex already exists
-		}
-		temp = temp->next;
+		return -1; // Vertex already exists
 	}
 
 	// Create a new vertex
-	vortex *new_vortex = new vortex;
+	vortex *new_vortex = vortex_pool.allocate();
 	new_vortex->vortex_index = vortex_index;
 	new_vortex->edge_ptr = nullptr;
 
-	// If the list is empty, set the new vortex as the head
-	if (graph_head == nullptr || graph_head->vortex_index > vortex_index)
+	// The closest lower index vortex in the table is the predecessor in the sorted list
+	vortex *previous = nullptr;
+	for (unsigned int i = vortex_index < this->vortex_index_range ? vortex_index : this->vortex_index_range; i > 0 && previous == nullptr; --i)
+	{
+		previous = this->vortex_table[i - 1];
+	}
+
+	// If there is no lower vortex, set the new vortex as the head
+	if (previous == nullptr)
 	{
 		new_vortex->next = graph_head;
 		graph_head = new_vortex;
 	}
 	else
 	{
-		// Traverse the list and insert the new vortex in the correct sorted position
-		vortex *current = graph_head;
-		while (current->next != nullptr && current->next->vortex_index < vortex_index)
-		{
-			current = current->next;
-		}
-		new_vortex->next = current->next;
-		current->next = new_vortex;
+		new_vortex->next = previous->next;
+		previous->next = new_vortex;
+	}
+
+	// Register the vortex in the index, growing it if the index is past the current range
+	if (vortex_index >= this->vortex_index_range)
+	{
+		grow_vortex_table(vortex_index + 1);
+		for (unsigned int i = this->vortex_index_range; i < vortex_index; ++i)
+			this->vortex_table[i] = nullptr;
+		this->vortex_index_range = vortex_index + 1;
+	}
+	this->vortex_table[vortex_index] = new_vortex;
+
+	// A vortex without edges is its own component, the index only has to be rebuilt if it does not cover it
+	if (vortex_index < this->component_capacity)
+	{
+		this->component_parent[vortex_index] = vortex_index;
+		this->component_size[vortex_index] = 1;
+	}
+	else
+	{
+		this->component_index_valid = false;
 	}
 
 	vortex_number++; // Increment the vortex count
@@ -266,33 +524,35 @@ int list_graph::add_vortex(unsigned int vortex_index)
 // Function to remove a vortex (vertex) from the graph
 int list_graph::remove_vortex(unsigned int vortex_index)
 {
-	vortex *current = graph_head;
+	release_query_snapshot();
+	vortex *current = find_vortex(vortex_index);
 	vortex *previous = nullptr;
 
-	// Traverse the list to find the vortex to remove
-	while (current != nullptr && current->vortex_index != vortex_index)
-	{
-		previous = current;
-		current = current->next;
-	}
-
 	// If the vortex is not found, return an error
 	if (current == nullptr)
 	{
 		return -1; // Vertex does not exist
 	}
 
+	// The closest lower index vortex in the table is the predecessor in the sorted list
+	for (unsigned int i = vortex_index; i > 0 && previous == nullptr; --i)
+	{
+		previous = this->vortex_table[i - 1];
+	}
+
 	// Remove all edges associated with this vortex
 	while (current->edge_ptr != nullptr)
 	{
 		edge *temp_edge = current->edge_ptr;
 		current->edge_ptr = current->edge_ptr->next;
-		delete temp_edge;
+		if (this->symmetric_storage) // the neighbor stores the other half of the edge
+			remove_edge_private(*find_vortex(temp_edge->vortex_index), vortex_index);
+		edge_pool.release(temp_edge);
 	}
 
-	// Remove any edges that point to this vortex
+	// Remove any edges that point to this vortex, only lower index vortexes can store them
 	vortex *temp = graph_head;
-	while (temp != nullptr)
+	while (!this->symmetric_storage && temp != current)
 	{
 		remove_edge_private(*temp, vortex_index); // Remove edges from other vertices
 		temp = temp->next;
@@ -309,7 +569,13 @@ int list_graph::remove_vortex(unsigned int vortex_index)
 		previous->next = current->next;
 	}
 
-	delete current;
+	vortex_pool.release(current);
+	this->vortex_table[vortex_index] = nullptr;
+	this->component_index_valid = false; // components may split, the index is rebuilt on the next query
+	while (this->vortex_index_range > 0 && this->vortex_table[this->vortex_index_range - 1] == nullptr)
+	{
+		this->vortex_index_range--; // shrink the index range if the highest vortex was removed
+	}
 	vortex_number--; // Decrease the vortex count
 	return 0;	 // Vertex removed successfully
 }
@@ -317,7 +583,8 @@ int list_graph::remove_vortex(unsigned int vortex_index)
 // adds an edge between 2 vortexs to a graph, if the edge already exists, just update the weight of the edge
 int list_graph::add_edge(unsigned int vortex1, unsigned int vortex2, unsigned int weight)
 {
-	if (vortex1 >= this->vortex_number || vortex2 >= this->vortex_number)
+	release_query_snapshot();
+	if (vortex1 >= this->vortex_index_range || vortex2 >= this->vortex_index_range)
 	{
 		return -1; // vortex index does not exist on this graph, so nothing is done
 	}
@@ -337,34 +604,12 @@ int list_graph::add_edge(unsigned int vortex1, unsigned int vortex2, unsigned in
 		return -2; // you cannot add and edge to the same vortex as base and goal
 	}
 
-	vortex *iterator_vortex = this->graph_head;
-	unsigned char found = 0;
-
-	for (int i = 0; i < this->vortex_number && iterator_vortex != nullptr; i++)
-	{ // finds the base vortex to add the edge
-		if (iterator_vortex->vortex_index == high_vortex)
-		{
-			found = 1;
-			break;
-		}
-		iterator_vortex = iterator_vortex->next;
-	}
-	if (!found)
+	if (find_vortex(high_vortex) == nullptr)
 	{
 		return -3; // not existing high vortex
 	}
-	iterator_vortex = this->graph_head;
-	found = 0;
-	for (int i = 0; i < this->vortex_number && iterator_vortex != nullptr; i++)
-	{ // finds the base vortex to add the edge
-		if (iterator_vortex->vortex_index == low_vortex)
-		{
-			found = 1;
-			break;
-		}
-		iterator_vortex = iterator_vortex->next;
-	}
-	if (!found)
+	vortex *iterator_vortex = find_vortex(low_vortex); // finds the base vortex of the edge
+	if (iterator_vortex == nullptr)
 	{
 		return -4; // not existing low vortex
 	}
@@ -375,20 +620,36 @@ int list_graph::add_edge(unsigned int vortex1, unsigned int vortex2, unsigned in
 	{ // checks the edge does not already exists
 		if (iterator_edge->vortex_index == high_vortex)
 		{ // if edge already exists, update the weight
+			if (weight < iterator_edge->edge_weight)
+				++this->shortening_version;
 			iterator_edge->edge_weight = weight;
+			if (weight > this->max_edge_weight)
+				this->max_edge_weight = weight;
+			if (this->symmetric_storage)
+			{ // and the weight of the half edge stored on the high vortex
+				for (iterator_edge = find_vortex(high_vortex)->edge_ptr; iterator_edge->vortex_index != low_vortex; iterator_edge = iterator_edge->next)
+					;
+				iterator_edge->edge_weight = weight;
+			}
 			return 1;
 		}
 		iterator_edge = iterator_edge->next;
 	}
 
 	add_edge_private((*iterator_vortex), high_vortex, weight); // if the edge does not exists, add a new edge
+	++this->shortening_version;
+	if (this->symmetric_storage)
+		add_edge_private(*find_vortex(high_vortex), low_vortex, weight);
+	if (this->component_index_valid)
+		union_components(low_vortex, high_vortex);
 	return 1;
 }
 
 // removes an edge between 2 vortexs only if the edge exists
 int list_graph::remove_edge(unsigned int vortex1, unsigned int vortex2)
 {
-	if (vortex1 >= this->vortex_number || vortex2 >= this->vortex_number)
+	release_query_snapshot();
+	if (vortex1 >= this->vortex_index_range || vortex2 >= this->vortex_index_range)
 	{
 		return -1; // vortex index does not exist on this graph, so nothing is done
 	}
@@ -407,166 +668,455 @@ int list_graph::remove_edge(unsigned int vortex1, unsigned int vortex2)
 	{
 		return -2; // you cannot add and edge to the same vortex as base and goal
 	}
-	vortex *iterator_vortex = this->graph_head;
-	unsigned char found = 0;
-
-	for (int i = 0; i < this->vortex_number && iterator_vortex != nullptr; i++)
-	{ // finds the base vortex to add the edge
-		if (iterator_vortex->vortex_index == high_vortex)
-		{
-			found = 1;
-			break;
-		}
-		iterator_vortex = iterator_vortex->next;
-	}
-	if (!found)
+	if (find_vortex(high_vortex) == nullptr)
 	{
 		return -3; // not existing high vortex
 	}
-	iterator_vortex = this->graph_head;
-	found = 0;
-	for (int i = 0; i < this->vortex_number && iterator_vortex != nullptr; i++)
-	{ // finds the base vortex to add the edge
-		if (iterator_vortex->vortex_index == low_vortex)
-		{
-			found = 1;
-			break;
-		}
-		iterator_vortex = iterator_vortex->next;
-	}
-	if (!found)
+	vortex *iterator_vortex = find_vortex(low_vortex); // finds the base vortex of the edge
+	if (iterator_vortex == nullptr)
 	{
 		return -4; // not existing low vortex
 	}
 
 	remove_edge_private((*iterator_vortex), high_vortex);
+	if (this->symmetric_storage)
+		remove_edge_private(*find_vortex(high_vortex), low_vortex);
+	this->component_index_valid = false; // components may split, the index is rebuilt on the next query
 	return 1;
 }
 
-// Generates random edges on the graph
+// the edge is stored on the lower index vortex with both storages, and its list is sorted
+int list_graph::get_edge_weight(unsigned int vortex1, unsigned int vortex2) const
+{
+	unsigned int low_vortex = vortex1 < vortex2 ? vortex1 : vortex2;
+	unsigned int high_vortex = vortex1 < vortex2 ? vortex2 : vortex1;
+	vortex *low = find_vortex(low_vortex);
+	if (low == nullptr || low_vortex == high_vortex)
+		return -1;
+	for (edge *current_edge = low->edge_ptr; current_edge != nullptr && current_edge->vortex_index <= high_vortex; current_edge = current_edge->next)
+	{
+		if (current_edge->vortex_index == high_vortex)
+			return (int)current_edge->edge_weight;
+	}
+	return -1;
+}
+
+// adds a batch of edges through the bulk builder, the valid edges are copied in normalized (low, high) form
+unsigned long long list_graph::add_edges(const edge_triple *edges, unsigned long long edge_number)
+{
+	release_query_snapshot();
+	generated_half_edge *batch_edges = new generated_half_edge[edge_number > 0 ? edge_number : 1];
+	unsigned long long batch_number = 0;
+	for (unsigned long long i = 0; i < edge_number; ++i)
+	{
+		unsigned int vortex1 = edges[i].vortex1, vortex2 = edges[i].vortex2;
+		if (vortex1 == vortex2 || find_vortex(vortex1) == nullptr || find_vortex(vortex2) == nullptr)
+			continue; // self loop or missing vortex, as add_edge() rejects them
+		batch_edges[batch_number++] = {vortex1 < vortex2 ? vortex1 : vortex2, vortex1 < vortex2 ? vortex2 : vortex1, edges[i].weight};
+	}
+	unsigned long long applied_number = merge_edge_batch(batch_edges, batch_number);
+	delete[] batch_edges;
+	return applied_number;
+}
+
+// Generates random edges on the graph, the percent roll <= cp_probability means a (cp_probability + 1) % edge probability
 void list_graph::generate_random_edges(unsigned int cp_probability)
 {
-	srand(time(0));
-	vortex *current_vortex = this->graph_head;
-	unsigned int random_int, edge_max = 0;
-	for (int i = 0; i < this->vortex_number; ++i)
+	release_query_snapshot();
+	generate_random_edges_gnp((cp_probability + 1) / 100.0, time(0));
+}
+
+// G(n, p) generator with geometric skipping (Batagelj-Brandes). Pairs (high, low) with low < high are
+// enumerated row by row, increasing high and then increasing low, and instead of rolling every pair, the
+// number of pairs until the next edge is drawn from a geometric distribution, log(1 - r) / log(1 - p).
+// Because of that order, each low vortex receives its edges with increasing high indexes, and each high
+// vortex (with symmetric storage) with increasing low indexes, so edges are appended at the list tails.
+void list_graph::generate_random_edges_gnp(double probability, unsigned long long seed, unsigned int thread_number)
+{
+	release_query_snapshot();
+	if (probability <= 0.0 || this->vortex_index_range < 2)
+		return;
+	if (thread_number > 1)
 	{
-		for (int j = this->vortex_number - 1; j > edge_max; --j)
+		generate_random_edges_gnp_parallel(probability, seed, thread_number);
+		return;
+	}
+
+	mt19937_64 generator(seed);
+	double log_no_edge = probability < 1.0 ? log(1.0 - probability) : 0.0;
+	edge **tails = collect_edge_tails();
+
+	unsigned long long high = 1, low = 0;
+	bool first_pair = true;
+	while (high < this->vortex_index_range)
+	{
+		// skip to the next pair with an edge
+		unsigned long long skip = 0;
+		if (probability < 1.0)
+		{
+			double random_real = (generator() >> 11) * (1.0 / 9007199254740992.0); // uniform in [0, 1)
+			double gap = floor(log(1.0 - random_real) / log_no_edge);
+			skip = gap < 9.0e18 ? (unsigned long long)gap : 9000000000000000000ULL;
+		}
+		if (first_pair)
+			first_pair = false;
+		else
+			skip += 1;
+		low += skip;
+		while (low >= high && high < this->vortex_index_range)
+		{
+			low -= high;
+			++high;
+		}
+		if (high >= this->vortex_index_range)
+			break;
+
+		unsigned int weight = (generator() % 9) + 1;
+		if (find_vortex(low) == nullptr || find_vortex(high) == nullptr)
+			continue; // removed index, no vortex to connect
+		append_generated_edge(low, high, weight, tails);
+	}
+	delete[] tails;
+}
+
+// Parallel G(n, p) in two phases. Generation: worker g runs the geometric skipping over its own rows of
+// high vortexes, with its own generator, and buckets every half edge by the worker owning the list it goes
+// to. Linking: worker k appends the half edges of its own vortexes, reading the buckets of workers 0, 1, ...
+// in order, which keeps the appends in increasing index order, and takes the nodes from a local pool that is
+// absorbed by the graph's edge pool at the end. Each list and tail is only touched by its owner.
+void list_graph::generate_random_edges_gnp_parallel(double probability, unsigned long long seed, unsigned int thread_number)
+{
+	release_query_snapshot();
+	unsigned int vortex_index_range = this->vortex_index_range;
+	if (thread_number > vortex_index_range)
+		thread_number = vortex_index_range;
+	double log_no_edge = probability < 1.0 ? log(1.0 - probability) : 0.0;
+
+	// row k of the pairs has k pairs, so splitting at n * sqrt(t / T) balances the pairs of every worker
+	unsigned int *row_begin = new unsigned int[thread_number + 1];
+	for (unsigned int t = 0; t <= thread_number; ++t)
+		row_begin[t] = (unsigned int)(vortex_index_range * sqrt((double)t / thread_number));
+	row_begin[0] = 1;
+	row_begin[thread_number] = vortex_index_range;
+	for (unsigned int t = 1; t < thread_number; ++t)
+		if (row_begin[t] < row_begin[t - 1])
+			row_begin[t] = row_begin[t - 1];
+
+	// vortex ranges owned by every worker in the linking phase
+	unsigned long long owner_span = ((unsigned long long)vortex_index_range + thread_number - 1) / thread_number;
+	dynamic_array<generated_half_edge> *buckets = new dynamic_array<generated_half_edge>[thread_number * thread_number];
+	unsigned int *worker_max_weight = new unsigned int[thread_number]();
+	bool symmetric = this->symmetric_storage;
+
+	auto generate_rows = [&](unsigned int worker) {
+		seed_seq worker_seed{(unsigned int)seed, (unsigned int)(seed >> 32), worker};
+		mt19937_64 generator(worker_seed);
+		dynamic_array<generated_half_edge> *worker_buckets = buckets + worker * thread_number;
+
+		unsigned long long high = row_begin[worker], low = 0;
+		unsigned long long row_end = row_begin[worker + 1];
+		bool first_pair = true;
+		while (high < row_end)
+		{
+			unsigned long long skip = 0;
+			if (probability < 1.0)
+			{
+				double random_real = (generator() >> 11) * (1.0 / 9007199254740992.0);
+				double gap = floor(log(1.0 - random_real) / log_no_edge);
+				skip = gap < 9.0e18 ? (unsigned long long)gap : 9000000000000000000ULL;
+			}
+			if (first_pair)
+				first_pair = false;
+			else
+				skip += 1;
+			low += skip;
+			while (low >= high && high < row_end)
+			{
+				low -= high;
+				++high;
+			}
+			if (high >= row_end)
+				break;
+
+			unsigned int weight = (generator() % 9) + 1;
+			if (find_vortex(low) == nullptr || find_vortex(high) == nullptr)
+				continue;
+			if (weight > worker_max_weight[worker])
+				worker_max_weight[worker] = weight;
+			worker_buckets[low / owner_span].push_back({(unsigned int)low, (unsigned int)high, weight});
+			if (symmetric)
+				worker_buckets[high / owner_span].push_back({(unsigned int)high, (unsigned int)low, weight});
+		}
+	};
+
+	edge **tails = collect_edge_tails();
+	node_pool<edge> *worker_pools = new node_pool<edge>[thread_number];
+
+	auto link_owned_edges = [&](unsigned int owner) {
+		for (unsigned int worker = 0; worker < thread_number; ++worker)
 		{
-			if ((rand() % 100) <= cp_probability)
+			dynamic_array<generated_half_edge> &bucket = buckets[worker * thread_number + owner];
+			for (unsigned long long i = 0; i < bucket.size(); ++i)
 			{
-				add_edge_private((*current_vortex), j, (rand() % 9) + 1);
+				generated_half_edge &half_edge = bucket[i];
+				append_edge_private(*this->vortex_table[half_edge.from_vortex], tails[half_edge.from_vortex], half_edge.to_vortex, half_edge.edge_weight, worker_pools[owner]);
 			}
+			bucket.release();
 		}
-		current_vortex = current_vortex->next;
-		++edge_max;
+	};
+
+	thread *workers = new thread[thread_number];
+	for (unsigned int t = 0; t < thread_number; ++t)
+		workers[t] = thread(generate_rows, t);
+	for (unsigned int t = 0; t < thread_number; ++t)
+		workers[t].join();
+	for (unsigned int t = 0; t < thread_number; ++t)
+		workers[t] = thread(link_owned_edges, t);
+	for (unsigned int t = 0; t < thread_number; ++t)
+		workers[t].join();
+
+	for (unsigned int t = 0; t < thread_number; ++t)
+	{
+		this->edge_pool.absorb(worker_pools[t]);
+		if (worker_max_weight[t] > this->max_edge_weight)
+			this->max_edge_weight = worker_max_weight[t];
 	}
+	++this->shortening_version;
+	this->component_index_valid = false; // the components index is rebuilt on the next query
+
+	delete[] workers;
+	delete[] worker_pools;
+	delete[] tails;
+	delete[] worker_max_weight;
+	delete[] buckets;
+	delete[] row_begin;
 }
-// returns an array of size this->vortex_number with 0 on reachable nodes, and -1on unreachable from base_node
+
+// returns an array of size this->vortex_index_range with 0 on reachable nodes, and -1on unreachable from base_node
 int *list_graph::get_full_reachable_vortexs(int base_vortex)
 {
-	int *ptr = new int[this->vortex_number];
-	for (int i = 0; i < vortex_number; ptr[i++] = -1)
-		;
-	full_reachable_vortexs(ptr, base_vortex);
+	if (base_vortex < 0 || find_vortex(base_vortex) == nullptr)
+	{
+		int *ptr = new int[this->vortex_index_range];
+		for (unsigned int i = 0; i < this->vortex_index_range; ptr[i++] = -1)
+			;
+		return ptr;
+	}
+	if (!this->component_index_valid && this->symmetric_storage)
+		return reachable_vortexs_breadth_first(*this, base_vortex); // neighbors are local, search only the component
+
+	if (!this->component_index_valid)
+		build_component_index();
+	int *ptr = new int[this->vortex_index_range];
+	unsigned int base_component = find_component(base_vortex);
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+		ptr[i] = (this->vortex_table[i] != nullptr && find_component(i) == base_component) ? 0 : -1;
 	return ptr;
 }
 
-// The algorithm initializes two main arrays: distance_frombase, which stores the minimum distances 
-// from base_vortex to each vertex (initialized to infinity), and predecessor, which tracks the preceding 
-// vertex in the shortest path for each reachable vertex. Additionally, a visited array marks nodes 
-// as they are fully processed to avoid redundant calculations.
-
-// Starting from base_vortex with a distance of zero, the function iteratively selects the unvisited 
-// vertex with the smallest known distance. For each neighbor of the current node, if the calculated 
-// path provides a shorter route than previously recorded, it updates both the neighbor's distance 
-// and sets the current node as its predecessor. This ensures that each node's predecessor represents 
-// the shortest path back to base_vortex.
-
-// The loop continues until either all reachable vertices are visited or the goal_vortex is reached. 
-// After completing the search, the algorithm checks if goal_vortex has a finite distance; if not, 
-// it returns -1, indicating that the goal_vortex is inaccessible from base_vortex. Otherwise, it 
-// backtracks from goal_vortex to base_vortex using the predecessor array, reconstructing and printing 
-// the shortest path.
-
-// Finally, the function frees the dynamically allocated memory for the distance_frombase, predecessor, 
-// and visited arrays and returns the shortest path distance from base_vortex to goal_vortex. If 
-// goal_vortex is inaccessible, the function returns -1.
-
-
-int list_graph::search_shortest_distance_dijkstra(unsigned int base_vortex, unsigned int goal_vortex) {
-    int *distance_frombase = new int[this->vortex_number];
-    int *predecessor = new int[this->vortex_number]; // Array to track predecessors
-    bool *visited = new bool[this->vortex_number](); // Track visited nodes
-
-    for (int i = 0; i < this->vortex_number; i++) {
-        distance_frombase[i] = numeric_limits<int>::max(); // Initial distance to infinity
-        predecessor[i] = -1; // Initialize predecessors to -1
-    }
-    distance_frombase[base_vortex] = 0;
-
-    unsigned int current_node = base_vortex;
-    unsigned int current_lower_distance;
-
-    while (true) {
-        reach_vortex(current_node, distance_frombase[current_node], distance_frombase);
-
-        // Update predecessors for undirected graph
-        vortex *current_vortex = this->graph_head;
-        for (int i = 0; i < current_node; ++i)
-            current_vortex = current_vortex->next;
-        edge *current_edge = current_vortex->edge_ptr;
-
-        while (current_edge != nullptr) {
-            if (distance_frombase[current_edge->vortex_index] != numeric_limits<int>::max() &&
-                distance_frombase[current_node] + current_edge->edge_weight == distance_frombase[current_edge->vortex_index]) {
-                predecessor[current_edge->vortex_index] = current_node;
-            }
-            if (distance_frombase[current_node] == distance_frombase[current_edge->vortex_index] + current_edge->edge_weight) {
-                predecessor[current_node] = current_edge->vortex_index;
-            }
-            current_edge = current_edge->next;
-        }
-
-        visited[current_node] = true;
-
-        if (current_node == goal_vortex || distance_frombase[current_node] == numeric_limits<int>::max()) {
-            break; // Exit if reached the goal or no further reachable nodes
-        }
-
-        // Find the unvisited node with the smallest distance
-        current_lower_distance = numeric_limits<int>::max();
-        for (int i = 0; i < this->vortex_number; ++i) {
-            if (!visited[i] && distance_frombase[i] < current_lower_distance) {
-                current_node = i;
-                current_lower_distance = distance_frombase[i];
-            }
-        }
-        
-        if (current_lower_distance == numeric_limits<int>::max()) {
-            break; // If no unvisited nodes with finite distance, exit
-        }
-    }
-
-    current_lower_distance = distance_frombase[goal_vortex];
-
-    // Print the shortest path if reachable
-    if (current_lower_distance != numeric_limits<int>::max()) {
-        cout << "Shortest path from " << base_vortex << " to " << goal_vortex << ": ";
-        int trace_node = goal_vortex;
-        while (trace_node != -1) {
-            cout << trace_node;
-            trace_node = predecessor[trace_node];
-            if (trace_node != -1)
-                cout << " <- ";
-        }
-        cout << endl;
-    } else {
-        cout << "No path from " << base_vortex << " to " << goal_vortex << " found." << endl;
-    }
-
-    delete[] distance_frombase;
-    delete[] predecessor;
-    delete[] visited;
-    return current_lower_distance != numeric_limits<int>::max() ? current_lower_distance : -1;
+// bitset of the reachable vortexes, from the components index when it is up to date, otherwise from a parallel
+// breadth first search with symmetric storage, or from the rebuilt components index
+unsigned long long *list_graph::get_reachable_bitset(unsigned int base_vortex, unsigned int thread_number)
+{
+	unsigned long long *visited = new unsigned long long[bitset_words(this->vortex_index_range)]();
+	if (find_vortex(base_vortex) == nullptr)
+		return visited;
+	if (!this->component_index_valid && this->symmetric_storage)
+	{
+		parallel_breadth_first_search(*this, [this](unsigned int vortex_index) { return this->vortex_table[vortex_index] != nullptr; }, base_vortex, thread_number, visited);
+		return visited;
+	}
+	if (!this->component_index_valid)
+		build_component_index();
+	unsigned int base_component = find_component(base_vortex);
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+	{
+		if (this->vortex_table[i] != nullptr && find_component(i) == base_component)
+			bitset_set(visited, i);
+	}
+	return visited;
+}
+
+// Afforest with symmetric storage, otherwise the union-find roots of the components index relabeled to the
+// lowest vortex index of every component (the first one met in index order)
+unsigned int *list_graph::get_component_labels(unsigned int &component_number, unsigned int thread_number)
+{
+	unsigned int *component_label = new unsigned int[this->vortex_index_range];
+	if (this->symmetric_storage)
+	{
+		component_number = connected_component_labels(*this, [this](unsigned int vortex_index) { return this->vortex_table[vortex_index] != nullptr; }, thread_number, component_label);
+		return component_label;
+	}
+	if (!this->component_index_valid)
+		build_component_index();
+	unsigned int *root_label = new unsigned int[this->vortex_index_range];
+	for (unsigned int i = 0; i < this->vortex_index_range; root_label[i++] = numeric_limits<unsigned int>::max())
+		;
+	component_number = 0;
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+	{
+		if (this->vortex_table[i] == nullptr)
+		{
+			component_label[i] = numeric_limits<unsigned int>::max();
+			continue;
+		}
+		unsigned int root = find_component(i);
+		if (root_label[root] == numeric_limits<unsigned int>::max())
+		{
+			root_label[root] = i;
+			++component_number;
+		}
+		component_label[i] = root_label[root];
+	}
+	delete[] root_label;
+	return component_label;
+}
+
+// checks if two vortexs are in the same connected component
+int list_graph::is_reachable(unsigned int vortex1, unsigned int vortex2)
+{
+	if (find_vortex(vortex1) == nullptr || find_vortex(vortex2) == nullptr)
+		return -1;
+	if (!this->component_index_valid)
+		build_component_index();
+	return find_component(vortex1) == find_component(vortex2) ? 1 : 0;
+}
+
+unsigned int list_graph::get_vortex_index_range() const
+{
+	return this->vortex_index_range;
+}
+
+// adds up the node pools and the index arrays of the graph
+void list_graph::get_memory_usage(unsigned long long &bytes_used, unsigned long long &bytes_reserved) const
+{
+	bytes_used = this->edge_pool.bytes_used() + this->vortex_pool.bytes_used() + this->vortex_index_range * sizeof(vortex *);
+	bytes_reserved = this->edge_pool.bytes_reserved() + this->vortex_pool.bytes_reserved() + this->vortex_table_capacity * sizeof(vortex *);
+	if (this->component_parent != nullptr)
+	{
+		bytes_used += 2 * this->component_capacity * sizeof(unsigned int);
+		bytes_reserved += 2 * this->component_capacity * sizeof(unsigned int);
+	}
+}
+
+unsigned long long list_graph::get_shortening_version() const
+{
+	return this->shortening_version;
+}
+
+bool list_graph::has_symmetric_storage() const
+{
+	return this->symmetric_storage;
+}
+
+// builds the compressed sparse row snapshot of the current graph
+compressed_graph *list_graph::freeze() const
+{
+	return new compressed_graph(*this);
+}
+
+// frees the snapshot, every public method changing the graph calls it first
+void list_graph::release_query_snapshot()
+{
+	lock_guard<mutex> lock(this->query_snapshot_mutex);
+	delete this->query_snapshot;
+	this->query_snapshot = nullptr;
+}
+
+// the graph does not change while queries run, so a snapshot built by one query stays valid for the others
+const compressed_graph &list_graph::get_query_snapshot() const
+{
+	lock_guard<mutex> lock(this->query_snapshot_mutex);
+	if (this->query_snapshot == nullptr)
+		this->query_snapshot = new compressed_graph(*this);
+	return *this->query_snapshot;
+}
+
+// listing the lower index neighbors of a vortex scans every lower index list, O(V) per settled vortex, so with
+// lower index storage the searches run on the snapshot, built once per version of the graph
+template <class Search>
+auto list_graph::search_neighbor_listing(Search search) const -> decltype(search(*this))
+{
+	if (this->symmetric_storage)
+		return search(*this);
+	return search(get_query_snapshot());
+}
+
+// Dijkstra's algorithm, implemented by dijkstra_search() in graph_search.h. The unvisited vertex with the
+// smallest known distance is taken from a priority queue (a 4-ary heap, or Dial's buckets for small integer
+// weights), its neighbors are relaxed, and each improved neighbor records the current node as its predecessor
+// and is pushed (or has its key lowered) in the queue.
+
+// The loop stops as soon as goal_vortex is settled, or when the queue runs out of reachable vertices. If
+// goal_vortex has a finite distance, the path is printed by backtracking the predecessor array, and the
+// distance is returned, otherwise -1 is returned.
+int list_graph::search_shortest_distance_dijkstra(unsigned int base_vortex, unsigned int goal_vortex, dijkstra_queue queue_type)
+{
+	if (find_vortex(base_vortex) == nullptr || find_vortex(goal_vortex) == nullptr)
+	{
+		cout << "No path from " << base_vortex << " to " << goal_vortex << " found." << endl;
+		return -1;
+	}
+	return search_neighbor_listing([&](const auto &graph) { return print_shortest_distance_dijkstra(graph, base_vortex, goal_vortex, queue_type, this->max_edge_weight); });
+}
+
+// quiet Dijkstra through shortest_path_dijkstra(), on the buffers of the caller's context
+int list_graph::search_shortest_path(search_context &context, unsigned int base_vortex, unsigned int goal_vortex, unsigned int *path, unsigned int path_capacity, unsigned int &path_length) const
+{
+	path_length = 0;
+	if (find_vortex(base_vortex) == nullptr || find_vortex(goal_vortex) == nullptr)
+		return -1;
+	return search_neighbor_listing([&](const auto &graph) { return shortest_path_dijkstra(graph, context, base_vortex, goal_vortex, path, path_capacity, path_length); });
+}
+
+// forward and backward searches through bidirectional_shortest_path_dijkstra()
+int list_graph::search_shortest_path_bidirectional(search_context &forward_context, search_context &backward_context, unsigned int base_vortex, unsigned int goal_vortex, unsigned int *path, unsigned int path_capacity, unsigned int &path_length) const
+{
+	path_length = 0;
+	if (find_vortex(base_vortex) == nullptr || find_vortex(goal_vortex) == nullptr)
+		return -1;
+	return search_neighbor_listing([&](const auto &graph) { return bidirectional_shortest_path_dijkstra(graph, forward_context, backward_context, base_vortex, goal_vortex, path, path_capacity, path_length); });
+}
+
+// A* through astar_shortest_path(), with the landmark bounds while they are valid and a zero heuristic otherwise
+int list_graph::search_shortest_path_alt(const alt_landmarks &landmarks, search_context &context, unsigned int base_vortex, unsigned int goal_vortex, unsigned int *path, unsigned int path_capacity, unsigned int &path_length) const
+{
+	path_length = 0;
+	if (find_vortex(base_vortex) == nullptr || find_vortex(goal_vortex) == nullptr)
+		return -1;
+	bool landmarks_valid = landmarks.is_valid_for(*this);
+	return search_neighbor_listing([&](const auto &graph) {
+		if (!landmarks_valid)
+			return astar_shortest_path(graph, context, [](unsigned int) { return 0; }, base_vortex, goal_vortex, path, path_capacity, path_length);
+		return astar_shortest_path(graph, context, [&](unsigned int vortex_index) { return landmarks.lower_bound(vortex_index, goal_vortex); }, base_vortex, goal_vortex, path, path_capacity, path_length);
+	});
+}
+
+// distance matrix through distance_matrix_dijkstra(), removed indexes count as missing vortexes
+int *list_graph::search_distance_matrix(const unsigned int *source_vortexs, unsigned int source_number, const unsigned int *target_vortexs, unsigned int target_number, unsigned int thread_number) const
+{
+	int *distance_matrix = new int[(unsigned long long)source_number * target_number];
+	search_neighbor_listing([&](const auto &graph) {
+		distance_matrix_dijkstra(graph, [this](unsigned int vortex_index) { return this->vortex_table[vortex_index] != nullptr; }, source_vortexs, source_number, target_vortexs, target_number, distance_matrix, thread_number);
+	});
+	return distance_matrix;
+}
+
+// delta-stepping through delta_stepping_distances(), unreachable vortexes become -1
+int *list_graph::search_all_distances(unsigned int base_vortex, unsigned int delta, unsigned int thread_number) const
+{
+	int *distance_frombase = new int[this->vortex_index_range];
+	if (find_vortex(base_vortex) == nullptr)
+	{
+		for (unsigned int i = 0; i < this->vortex_index_range; distance_frombase[i++] = -1)
+			;
+		return distance_frombase;
+	}
+	if (delta == 0)
+		delta = this->max_edge_weight > 0 ? this->max_edge_weight : 1;
+	search_neighbor_listing([&](const auto &graph) { delta_stepping_distances(graph, base_vortex, delta, this->max_edge_weight, thread_number, distance_frombase); });
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+		if (distance_frombase[i] == numeric_limits<int>::max())
+			distance_frombase[i] = -1;
+	return distance_frombase;
 }
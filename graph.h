@@ -11,7 +11,9 @@
  * 
  * The graph is implemented using an adjacency linked list where only existing edges are represented, stored on the lower index vortex (node), to save memory. This implementation is particularly efficient for sparse graphs, which are common in real-world applications such as representing city networks or social network contacts.
  * 
- * The implementation focuses on being as low-level as possible to optimize speed and memory usage, deliberately avoiding high-level C++ data structures like the `vector` class to maintain control over memory management and performance.
+ * Optionally, the graph can be built with symmetric storage, where each edge is stored on both of its vortexes. This doubles the edge memory, but listing the neighbors of a vortex only touches its own adjacency list, instead of scanning every lower index vortex. The shortest path queries of a graph with lower index storage run on a CSR snapshot (see compressed_graph.h) built by the first query after a change and kept until the next one, so the scan is paid once per version of the graph; with symmetric storage they run on the lists directly.
+ * 
+ * The implementation focuses on being as low-level as possible to optimize speed and memory usage, deliberately avoiding high-level C++ data structures like the `vector` class to maintain control over memory management and performance. Edges and vortexes are carved out of slab pools (see node_pool.h) instead of being allocated one by one.
  */
 
 #include <ctime>
@@ -19,9 +21,18 @@
 #include <random>
 #include <string>
 #include <limits>
+#include <mutex>
+
+#include "node_pool.h"
+#include "search_context.h"
+#include "vortex_queue.h"
 
 using namespace std;
 
+class compressed_graph;
+class alt_landmarks;
+class dynamic_shortest_paths;
+
 /**
  * @struct edge
  * @brief Represents an edge in the graph.
@@ -49,6 +60,39 @@ typedef struct vortex
 
 } vortex;
 
+/**
+ * @struct generated_half_edge
+ * @brief An edge produced by a generator or an importer, waiting to be linked on the list of from_vortex.
+ */
+struct generated_half_edge
+{
+    unsigned int from_vortex;  /**< Vortex whose list receives the edge. */
+    unsigned int to_vortex;    /**< Target vortex of the edge. */
+    unsigned int edge_weight;  /**< Weight of the edge. */
+};
+
+/**
+ * @struct edge_triple
+ * @brief An undirected edge given to list_graph::add_edges(), the vortexes can come in any order.
+ */
+struct edge_triple
+{
+    unsigned int vortex1;  /**< Index of one vortex of the edge. */
+    unsigned int vortex2;  /**< Index of the other vortex of the edge. */
+    unsigned int weight;   /**< Weight of the edge. */
+};
+
+/**
+ * @enum graph_file_format
+ * @brief Text formats read by list_graph::import_edges().
+ */
+enum graph_file_format
+{
+    EDGE_LIST_FILE,    /**< One "u v [weight]" edge per line, 0-based indexes, weight 1 when missing, lines starting with # or % are comments. */
+    DIMACS_FILE,       /**< DIMACS shortest path (.gr): "a u v weight" arcs with 1-based indexes, "c" comment lines and a "p sp n m" problem line. */
+    MATRIX_MARKET_FILE /**< Matrix Market coordinate format: % comment lines, a "rows columns entries" size line, then "i j [value]" entries with 1-based indexes. */
+};
+
 /**
  * @class list_graph
  * @brief Represents an undirected graph using an adjacency linked list structure.
@@ -65,13 +109,14 @@ public:
      * 
      * @param vortex_number Number of vortexes in the graph.
      * @param graph_name The name of the graph.
+     * @param symmetric_storage If true, every edge is stored on both vortexes (twice the edge memory, neighbor listing in O(degree)), otherwise only on the lower index vortex.
      */
-    list_graph(int vortex_number, string graph_name);
+    list_graph(int vortex_number, string graph_name, bool symmetric_storage = false);
 
     /**
      * @brief Destructor that frees dynamically allocated memory.
      *
-     * The destructor deallocates memory for all vortexes and edges in the graph, ensuring proper cleanup.
+     * The destructor deallocates memory for all vortexes and edges in the graph, ensuring proper cleanup. Nodes live in slab pools, so they are released slab by slab instead of one at a time.
      */
     ~list_graph();
 
@@ -114,7 +159,7 @@ public:
     /**
      * @brief Adds an edge between two vortexes in the graph.
      *
-     * Creates an edge between two vortexes with the specified weight. The edge is added to the adjacency list of the lower-index vortex.
+     * Creates an edge between two vortexes with the specified weight. The edge is added to the adjacency list of the lower-index vortex, and also to the higher-index one with symmetric storage.
      * 
      * @param vortex1 The index of the first vortex.
      * @param vortex2 The index of the second vortex.
@@ -136,31 +181,247 @@ public:
      */
     int remove_edge(unsigned int vortex1, unsigned int vortex2);
 
+    /**
+     * @brief Returns the weight of the edge between two vortexes.
+     *
+     * @param vortex1 The index of the first vortex.
+     * @param vortex2 The index of the second vortex.
+     *
+     * @return The weight of the edge, or -1 if there is no edge between them or a vortex does not exist.
+     */
+    int get_edge_weight(unsigned int vortex1, unsigned int vortex2) const;
+
+    /**
+     * @brief Adds or updates a batch of edges at once, for bulk loads of millions of edges.
+     *
+     * Calling add_edge() per edge walks the adjacency list of the lower vortex for every edge, which is quadratic in the degree of high degree vortexes. Here the batch is copied, radix sorted by (lower index, higher index) and merged into the sorted adjacency lists in a single walk of every list receiving edges, so the cost is linear in the batch plus the lists touched.
+     *
+     * Edges already in the graph get the new weight, as add_edge() does, and when an edge is repeated in the batch the last copy wins. Self loops and edges naming a vortex that does not exist are skipped. Needs 24 bytes of temporary memory per edge of the batch (twice that with symmetric storage).
+     *
+     * @param edges The edges to add.
+     * @param edge_number Number of edges in the array.
+     *
+     * @return The number of distinct edges applied: repeated copies of an edge count once, and the skipped edges are not counted.
+     */
+    unsigned long long add_edges(const edge_triple *edges, unsigned long long edge_number);
+
     /**
      * @brief Generates random edges in the graph with a given probability.
      *
-     * Randomly generates edges between vortexes in the graph, with the probability of each edge being created determined by the provided parameter.
+     * Randomly generates edges between vortexes in the graph, with the probability of each edge being created determined by the provided parameter. Each edge is created when a percent roll from 0 to 99 is lower or equal to cp_probability, so the edge probability is (cp_probability + 1) / 100. Seeded from the current time, see generate_random_edges_gnp() for reproducible graphs.
      * 
      * @param cp_probability The probability (0 to 100) that each possible edge will be generated.
      */
     void generate_random_edges(unsigned int cp_probability);
 
+    /**
+     * @brief Generates an Erdos-Renyi G(n, p) random graph over the existing vortexes.
+     *
+     * Every pair of vortexes gets an edge with the given probability and a random weight from 1 to 9. Instead of rolling once per pair, the generator draws the geometric gap to the next edge (Batagelj-Brandes), so the cost is proportional to the vortexes plus the generated edges, not to the square of the vortexes. Edges come out sorted, and are appended at the end of the adjacency lists without walking them. If an edge already exists, its weight is updated, as add_edge() does.
+     * 
+     * With more than one thread, the rows of vortex pairs are split across worker threads with balanced pair counts, each with its own generator seeded from (seed, thread number). Workers fill thread-local edge buffers, then each worker links the edges of its own range of vortexes, taking nodes from a thread-local pool, so no locks are needed. The result is the same for the same seed and thread count, but differs between thread counts.
+     * 
+     * @param probability Probability of each edge, from 0.0 to 1.0.
+     * @param seed Seed of the std::mt19937_64 generator, the same seed on the same graph gives the same edges.
+     * @param thread_number Number of worker threads, 1 generates on the calling thread.
+     */
+    void generate_random_edges_gnp(double probability, unsigned long long seed, unsigned int thread_number = 1);
+
+    /**
+     * @brief Generates a power-law graph with the R-MAT (recursive matrix) model.
+     *
+     * Each edge picks its vortexes by descending the quadrants of the adjacency matrix, choosing the top-left, top-right, bottom-left or bottom-right quadrant with probability a, b, c and 1 - a - b - c at each of the log2(n) levels. Skewed probabilities (such as 0.57, 0.19, 0.19) give the heavy-tailed degrees of social graphs. Edges are streamed into the graph one by one, the generator itself keeps no state per edge. Samples falling on a self loop or on a missing vortex are dropped, and repeated samples update the weight of the existing edge. Weights are random from 1 to 9.
+     * 
+     * @param edge_number Number of edges to sample.
+     * @param a Probability of the top-left quadrant.
+     * @param b Probability of the top-right quadrant.
+     * @param c Probability of the bottom-left quadrant.
+     * @param seed Seed of the std::mt19937_64 generator.
+     * 
+     * @return 0 on success, or -1 if the probabilities are not valid.
+     */
+    int generate_rmat_edges(unsigned long long edge_number, double a, double b, double c, unsigned long long seed);
+
+    /**
+     * @brief Generates a scale-free graph with Barabasi-Albert preferential attachment.
+     *
+     * Vortexes join the graph in index order, and each one links to attach_edges distinct vortexes already in the graph, chosen with probability proportional to their degree. The first attach_edges + 1 vortexes start as a star around the vortex attach_edges. Sampling by degree uses the list of edge endpoints generated so far, 8 bytes per generated edge, released when done. Weights are random from 1 to 9.
+     * 
+     * @param attach_edges Number of edges of every new vortex.
+     * @param seed Seed of the std::mt19937_64 generator.
+     * 
+     * @return 0 on success, or -1 if attach_edges is 0 or the graph has no more than attach_edges vortexes.
+     */
+    int generate_barabasi_albert_edges(unsigned int attach_edges, unsigned long long seed);
+
+    /**
+     * @brief Generates a random geometric graph, a near-planar model of road and sensor networks.
+     *
+     * Every vortex gets a random point in the unit square, and vortexes closer than radius are connected, with a weight from 1 to 9 growing with the distance. Points are bucketed in a grid of radius sized cells, so only the 9 cells around each point are checked. Uses up to 24 bytes per vortex while generating: 8 for the point, 4 for its cell entry, up to 4 for the cell table and 8 for the tail of its adjacency list.
+     * 
+     * @param radius Connection radius, from 0.0 to 1.0.
+     * @param seed Seed of the std::mt19937_64 generator.
+     * 
+     * @return 0 on success, or -1 if the radius is not valid.
+     */
+    int generate_geometric_edges(double radius, unsigned long long seed);
+
+    /**
+     * @brief Generates a 2D grid graph with perturbed weights, a simple road-like network.
+     *
+     * Vortex i is placed at column i % width and row i / width, and is linked to its right and bottom neighbors. Every edge weight is base_weight plus a random perturbation in [-max_perturbation, max_perturbation], at least 1. Edges are produced in order and appended directly after the tail of each adjacency list, using 8 bytes per vortex for the tails while generating.
+     * 
+     * @param width Number of columns of the grid.
+     * @param base_weight Weight of an unperturbed edge.
+     * @param max_perturbation Largest change applied to the base weight.
+     * @param seed Seed of the std::mt19937_64 generator.
+     * 
+     * @return 0 on success, or -1 if the width is 0.
+     */
+    int generate_grid_edges(unsigned int width, unsigned int base_weight, unsigned int max_perturbation, unsigned long long seed);
+
+    /**
+     * @brief Imports the edges of a text file (edge list, DIMACS .gr or Matrix Market) into the graph.
+     *
+     * The file is streamed in chunks of 64 MiB, never loaded whole: while one chunk is parsed the next one is read by another thread, and every chunk is split at line boundaries across thread_number parser threads, which read integers with a hand written parser instead of iostream. The edges of each chunk are then sorted, deduplicated (the last occurrence in the file wins) and merged into the sorted adjacency lists in one pass per list.
+     *
+     * Edges are undirected, so "u v" and "v u" are the same edge, and self loops are dropped. Edges that already exist in the graph get the weight read, as add_edge() does. Vortexes missing in the graph are added: every index up to the vortex count declared by the DIMACS problem line or the Matrix Market size line, and up to the highest index read. Matrix Market values are rounded to their absolute integer value, at least 1.
+     *
+     * @param file_path Path of the file to read.
+     * @param format Format of the file.
+     * @param thread_number Number of parser threads.
+     *
+     * @return 0 on success, -1 if the file cannot be opened, or -2 on a malformed line (the chunks before it stay imported).
+     */
+    int import_edges(const char *file_path, graph_file_format format, unsigned int thread_number = 1);
+
     /**
      * @brief Finds the shortest path between two vortexes using Dijkstra's algorithm.
      *
-     * Implements Dijkstra's algorithm to find the shortest path from a base vortex to a goal vortex in the graph. It computes the shortest distance and updates the distance array.
+     * Implements Dijkstra's algorithm to find the shortest path from a base vortex to a goal vortex in the graph, and prints the path found. The next vortex to settle is taken from a priority queue, and the search stops as soon as the goal vortex is settled.
+     *
+     * With lower index storage, listing the neighbors of a vortex scans every lower index list (O(V) per settled vortex, O(V^2) per query), so the search runs instead on a CSR snapshot of the graph, built by the first query after a change and reused by the next ones, see release_query_snapshot(). With symmetric storage it runs on the lists directly.
+     * 
+     * @param base_vortex The index of the starting vortex.
+     * @param goal_vortex The index of the goal vortex.
+     * @param queue_type The priority queue used, a 4-ary heap by default, or Dial's bucket queue for small integer weights.
      * 
+     * @return The shortest distance, or -1 if the goal vortex is not reachable.
+     */
+    int search_shortest_distance_dijkstra(unsigned int base_vortex, unsigned int goal_vortex, dijkstra_queue queue_type = DARY_HEAP_QUEUE);
+
+    /**
+     * @brief Finds the shortest path between two vortexes and returns it, without printing.
+     *
+     * The quiet counterpart of search_shortest_distance_dijkstra() for query loops: the search runs on the buffers of a search_context owned by the caller, reused from one query to the next and reset lazily, and the path is copied to a caller-provided array. Each thread uses its own context. The graph must not be modified while queries run.
+     *
+     * Nothing is allocated with symmetric storage. With lower index storage it runs on the CSR snapshot of release_query_snapshot(), which the first query after a change of the graph builds (O(V + E) time, 16 bytes per edge) and the next ones reuse.
+     *
+     * @param context The search buffers, see search_context.h.
+     * @param base_vortex The index of the starting vortex.
+     * @param goal_vortex The index of the goal vortex.
+     * @param path Output, the vortexes of the path from base_vortex to goal_vortex, both included. Only written if the path fits.
+     * @param path_capacity Number of elements of path.
+     * @param path_length Output, the number of vortexes of the path, 0 if there is none. When it is bigger than path_capacity, path is left untouched and the query can be repeated with a bigger array.
+     *
+     * @return The shortest distance, or -1 if the goal vortex is not reachable or a vortex does not exist.
+     */
+    int search_shortest_path(search_context &context, unsigned int base_vortex, unsigned int goal_vortex, unsigned int *path, unsigned int path_capacity, unsigned int &path_length) const;
+
+    /**
+     * @brief Finds the shortest path between two vortexes with a bidirectional Dijkstra search, without printing.
+     *
+     * Same result as search_shortest_path(), the distance is identical and the path is a shortest one (it can differ when several paths tie). A forward search from base_vortex and a backward search from goal_vortex run in turns until they meet, which settles far fewer vortexes on point to point queries. See bidirectional_shortest_path_dijkstra() in graph_search.h. With lower index storage it runs on the query snapshot, as search_shortest_path() does.
+     *
+     * @param forward_context The buffers of the forward search.
+     * @param backward_context The buffers of the backward search, a different context of the same thread.
+     * @param base_vortex The index of the starting vortex.
+     * @param goal_vortex The index of the goal vortex.
+     * @param path Output, the vortexes of the path from base_vortex to goal_vortex, both included. Only written if the path fits.
+     * @param path_capacity Number of elements of path.
+     * @param path_length Output, the number of vortexes of the path, 0 if there is none, also when it does not fit in path.
+     *
+     * @return The shortest distance, or -1 if the goal vortex is not reachable or a vortex does not exist.
+     */
+    int search_shortest_path_bidirectional(search_context &forward_context, search_context &backward_context, unsigned int base_vortex, unsigned int goal_vortex, unsigned int *path, unsigned int path_capacity, unsigned int &path_length) const;
+
+    /**
+     * @brief Finds the shortest path between two vortexes with A* guided by landmark lower bounds (ALT), without printing.
+     *
+     * Same result as search_shortest_path(), settling far fewer vortexes: the queue is ordered by distance plus the landmark lower bound of the distance to the goal. If an edge was added or a weight lowered since the landmarks were built, their bounds could be too big and are not used, the search is then Dijkstra's until the landmarks are built again. Raised weights and removals keep them in use. With lower index storage it runs on the query snapshot, as search_shortest_path() does, so the landmarks and the queries share the snapshot built after the last change.
+     *
+     * @param landmarks Landmark distance tables built on this graph, see alt_landmarks.h.
+     * @param context The search buffers, see search_context.h.
      * @param base_vortex The index of the starting vortex.
      * @param goal_vortex The index of the goal vortex.
+     * @param path Output, the vortexes of the path from base_vortex to goal_vortex, both included. Only written if the path fits.
+     * @param path_capacity Number of elements of path.
+     * @param path_length Output, the number of vortexes of the path, 0 if there is none, also when it does not fit in path.
+     *
+     * @return The shortest distance, or -1 if the goal vortex is not reachable or a vortex does not exist.
+     */
+    int search_shortest_path_alt(const alt_landmarks &landmarks, search_context &context, unsigned int base_vortex, unsigned int goal_vortex, unsigned int *path, unsigned int path_capacity, unsigned int &path_length) const;
+
+    /**
+     * @brief Computes the shortest distance between every source vortex and every target vortex, without printing.
+     *
+     * A distance matrix in one call instead of one search_shortest_distance_dijkstra() per pair: one Dijkstra search per source, stopped as soon as every target is settled, with the search arrays allocated once per worker thread and reset only where a search touched them. Sources are spread across thread_number threads. See distance_matrix_dijkstra() in graph_search.h.
      * 
-     * @return 0 if successful, or an error code if the algorithm failed.
+     * The graph is only read, so the threads need no locks, but it must not be modified during the call. With lower index storage the searches run on the query snapshot, see release_query_snapshot().
+     *
+     * @param source_vortexs The source vortexes, the rows of the matrix.
+     * @param source_number Number of sources.
+     * @param target_vortexs The target vortexes, the columns of the matrix.
+     * @param target_number Number of targets.
+     * @param thread_number Number of threads searching sources in parallel.
+     *
+     * @return A dynamically allocated array of source_number * target_number distances, the distance from source i to target j at i * target_number + j, -1 where the target is not reachable or a vortex does not exist. Released by the caller with delete[].
+     */
+    int *search_distance_matrix(const unsigned int *source_vortexs, unsigned int source_number, const unsigned int *target_vortexs, unsigned int target_number, unsigned int thread_number = 1) const;
+
+    /**
+     * @brief Computes the distance from a vortex to every vortex with parallel delta-stepping, without printing.
+     *
+     * For full single source sweeps on big graphs: the buckets of delta-stepping are processed by thread_number threads at once, relaxing edges with an atomic minimum on the distances. The distances are exactly the ones of Dijkstra's algorithm. See delta_stepping_distances() in graph_search.h. The graph must not be modified during the call. With lower index storage the sweep runs on the query snapshot, see release_query_snapshot().
+     *
+     * @param base_vortex The index of the starting vortex.
+     * @param delta The bucket width, edges up to delta are relaxed inside their bucket and heavier ones once per bucket. 0 picks the maximum edge weight, making every edge light.
+     * @param thread_number Number of threads.
+     *
+     * @return A dynamically allocated array of get_vortex_index_range() distances, -1 on the vortexes not reachable from base_vortex (all of them if it does not exist). Released by the caller with delete[].
      */
-    int search_shortest_distance_dijkstra(unsigned int base_vortex, unsigned int goal_vortex);
+    int *search_all_distances(unsigned int base_vortex, unsigned int delta = 0, unsigned int thread_number = 1) const;
+
+    /**
+     * @brief Returns the vortexes reachable from a base vortex as a bitset, one bit per vortex index.
+     *
+     * A compact replacement of get_full_reachable_vortexs(): bit (i & 63) of word i / 64 is set when vortex i is reachable, 8 bytes per 64 vortexes instead of 4 per vortex. The answer is read from the connected components index when it is up to date. Otherwise, with symmetric storage a direction-optimizing breadth first search is run by thread_number threads (see parallel_breadth_first_search() in graph_search.h), and with lower index storage the components index is rebuilt.
+     *
+     * @param base_vortex The index of the base vortex.
+     * @param thread_number Number of threads of the search.
+     *
+     * @return A dynamically allocated array of (get_vortex_index_range() + 63) / 64 words, all zero if the base vortex does not exist. Released by the caller with delete[].
+     */
+    unsigned long long *get_reachable_bitset(unsigned int base_vortex, unsigned int thread_number = 1);
+
+    /**
+     * @brief Labels every vortex with its connected component, the lowest vortex index of the component.
+     *
+     * With symmetric storage runs the parallel Afforest algorithm of connected_component_labels() in graph_search.h on thread_number threads. With lower index storage the neighbors of a vortex are not local, so the labels are read from the union-find components index, rebuilt first if needed. Two vortexes are connected if and only if they have the same label.
+     *
+     * @param component_number Output, the number of connected components.
+     * @param thread_number Number of threads.
+     *
+     * @return A dynamically allocated array of get_vortex_index_range() labels, numeric_limits<unsigned int>::max() on the indexes without a vortex. Released by the caller with delete[].
+     */
+    unsigned int *get_component_labels(unsigned int &component_number, unsigned int thread_number = 1);
 
     /**
      * @brief Retrieves all reachable vortexes from a given base vortex.
      *
-     * This function returns a dynamically allocated array where each element represents the reachability of a vortex from the base vortex. A value of 1 indicates the vortex is reachable, and 0 indicates it is not.
+     * This function returns a dynamically allocated array of get_vortex_index_range() elements where each element represents the reachability of a vortex from the base vortex. A value of 0 indicates the vortex is reachable, and -1 indicates it is not.
+     * 
+     * The answer is read from the connected components index when it is up to date. Otherwise, with symmetric storage an iterative breadth first search is run from the base vortex, and with lower index storage the components index is rebuilt, both in linear time.
      * 
      * @param base_node The index of the base vortex.
      * 
@@ -168,10 +429,230 @@ public:
      */
     int *get_full_reachable_vortexs(int base_node);
 
+    /**
+     * @brief Checks if there is a path between two vortexes.
+     *
+     * Uses a union-find index of the connected components. The index is built in linear time on the first query, kept up to date by edge and vortex additions, and rebuilt on the next query after an edge or vortex removal, so queries between removals take near constant time.
+     * 
+     * @param vortex1 The index of the first vortex.
+     * @param vortex2 The index of the second vortex.
+     * 
+     * @return 1 if the vortexes are connected, 0 if they are not, or -1 if one of them does not exist.
+     */
+    int is_reachable(unsigned int vortex1, unsigned int vortex2);
+
+    /**
+     * @brief Freezes the graph into an immutable compressed sparse row snapshot.
+     *
+     * Builds a compressed_graph holding both directions of every edge in contiguous arrays, for workloads that run many queries between changes of the graph. The snapshot is independent of this graph: later changes are not reflected on it.
+     *
+     * @return A dynamically allocated compressed_graph, released by the caller with delete.
+     */
+    compressed_graph *freeze() const;
+
+    /**
+     * @brief Returns the size of the vortex index space (highest vortex index plus one).
+     *
+     * Arrays returned by the query methods are indexed by vortex index and have this size, which is larger than the number of vortexes when some indexes were removed.
+     */
+    unsigned int get_vortex_index_range() const;
+
+    /**
+     * @brief Reports the memory of the graph structure.
+     *
+     * Counts the edge and vortex pools and the index arrays (vortex index and connected components index), not the graph name.
+     *
+     * @param bytes_used Output, bytes of the nodes and index entries in use.
+     * @param bytes_reserved Output, bytes allocated, including free pool nodes and spare index capacity.
+     */
+    void get_memory_usage(unsigned long long &bytes_used, unsigned long long &bytes_reserved) const;
+
+    /**
+     * @brief Returns a counter of the changes that can make a shortest path shorter: added edges and lowered weights.
+     *
+     * Raised weights and removed edges or vortexes only make paths longer and do not change it. Structures derived from the distances of the graph, like the alt_landmarks lower bounds, stay valid while it does not change.
+     */
+    unsigned long long get_shortening_version() const;
+
+    /**
+     * @brief Returns true if every edge is stored on both of its vortexes.
+     */
+    bool has_symmetric_storage() const;
+
+    /**
+     * @brief Frees the CSR snapshot the shortest path queries run on with lower index storage.
+     *
+     * With lower index storage the queries need the lower index neighbors of every vortex they settle, a scan of every lower index list, so the first query after a change builds a compressed_graph of the graph (O(V + E) time, 16 bytes per edge) and the next ones reuse it. Every change of the graph frees it. Call this to get the memory back when no more queries are coming; symmetric storage never builds it.
+     */
+    void release_query_snapshot();
+
+    /**
+     * @brief Calls function(neighbor_index, edge_weight) for every neighbor of a vortex.
+     *
+     * With symmetric storage only the vortex's own list is read. Otherwise edges to higher index neighbors are read from the vortex's own list, and edges to lower index neighbors are stored on those vortexes, so every lower index list is scanned up to the vortex index (lists are sorted, so the scan of each list stops there).
+     *
+     * @param vortex_index The index of the vortex, must exist in the graph.
+     * @param function Callable taking (unsigned int neighbor_index, unsigned int edge_weight).
+     */
+    template <class Function>
+    void for_each_neighbor(unsigned int vortex_index, Function function) const
+    {
+        for (unsigned int i = 0; i < vortex_index && !this->symmetric_storage; ++i)
+        {
+            if (this->vortex_table[i] == nullptr)
+                continue;
+            for (edge *current_edge = this->vortex_table[i]->edge_ptr; current_edge != nullptr && current_edge->vortex_index <= vortex_index; current_edge = current_edge->next)
+            {
+                if (current_edge->vortex_index == vortex_index)
+                    function(i, current_edge->edge_weight);
+            }
+        }
+        for (edge *current_edge = this->vortex_table[vortex_index]->edge_ptr; current_edge != nullptr; current_edge = current_edge->next)
+            function(current_edge->vortex_index, current_edge->edge_weight);
+    }
+
+    /**
+     * @brief Returns true if predicate(neighbor_index, edge_weight) is true for some neighbor of a vortex, stopping at the first one.
+     *
+     * Reads the neighbors in the order of for_each_neighbor().
+     *
+     * @param vortex_index The index of the vortex, must exist in the graph.
+     * @param predicate Callable taking (unsigned int neighbor_index, unsigned int edge_weight) and returning bool.
+     */
+    template <class Predicate>
+    bool any_neighbor(unsigned int vortex_index, Predicate predicate) const
+    {
+        for (unsigned int i = 0; i < vortex_index && !this->symmetric_storage; ++i)
+        {
+            if (this->vortex_table[i] == nullptr)
+                continue;
+            for (edge *current_edge = this->vortex_table[i]->edge_ptr; current_edge != nullptr && current_edge->vortex_index <= vortex_index; current_edge = current_edge->next)
+            {
+                if (current_edge->vortex_index == vortex_index && predicate(i, current_edge->edge_weight))
+                    return true;
+            }
+        }
+        for (edge *current_edge = this->vortex_table[vortex_index]->edge_ptr; current_edge != nullptr; current_edge = current_edge->next)
+            if (predicate(current_edge->vortex_index, current_edge->edge_weight))
+                return true;
+        return false;
+    }
+
 private:
+    friend class compressed_graph;
+    friend class alt_landmarks;
+    friend class dynamic_shortest_paths;
+
+
     string graph_name;  /**< The name of the graph. */
     int vortex_number;  /**< The number of vortexes in the graph. */
     vortex *graph_head; /**< Pointer to the first vortex in the graph. */
+    node_pool<edge> edge_pool;          /**< Slab allocator of the edges. */
+    node_pool<vortex> vortex_pool;      /**< Slab allocator of the vortexes. */
+    bool symmetric_storage;             /**< If true every edge is stored on both vortexes, otherwise only on the lower index one. */
+    vortex **vortex_table;              /**< Direct-addressed index, vortex_table[i] is the vortex with index i or nullptr. */
+    unsigned int vortex_table_capacity; /**< Number of slots allocated in vortex_table. */
+    unsigned int vortex_index_range;    /**< Highest existing vortex index plus one. */
+    unsigned int max_edge_weight;       /**< Upper bound of the edge weights ever added, sizes Dial's bucket queue. */
+    unsigned long long shortening_version; /**< Number of changes that could shorten a path, see get_shortening_version(). */
+    unsigned int *component_parent;     /**< Union-find parent of every vortex index. */
+    unsigned int *component_size;       /**< Union-find size of every component, valid on the representatives. */
+    unsigned int component_capacity;    /**< Number of vortex indexes covered by the components index. */
+    bool component_index_valid;         /**< False when the components index has to be rebuilt before use. */
+    mutable compressed_graph *query_snapshot; /**< CSR copy the queries run on with lower index storage, nullptr until a query needs it after a change. */
+    mutable mutex query_snapshot_mutex; /**< Lets concurrent queries build query_snapshot once. */
+
+    /**
+     * @brief Returns the CSR snapshot of the graph, built if a change freed it. Thread safe among queries.
+     */
+    const compressed_graph &get_query_snapshot() const;
+
+    /**
+     * @brief Runs search(graph) on the lists with symmetric storage, and on the query snapshot with lower index storage.
+     */
+    template <class Search>
+    auto search_neighbor_listing(Search search) const -> decltype(search(*this));
+
+    /**
+     * @brief Finds a vortex by its index in constant time.
+     *
+     * @param vortex_index The index of the vortex.
+     *
+     * @return Pointer to the vortex, or nullptr if there is no vortex with that index.
+     */
+    vortex *find_vortex(unsigned int vortex_index) const;
+
+    /**
+     * @brief Grows the vortex index so it can hold at least the given number of slots.
+     *
+     * The capacity is at least doubled so a sequence of add_vortex calls with increasing indexes costs amortized constant time.
+     *
+     * @param min_capacity Minimum number of slots needed.
+     */
+    void grow_vortex_table(unsigned int min_capacity);
+
+    /**
+     * @brief Adds or updates an edge on a vortex, appending it if it goes after the last edge of the list.
+     *
+     * Used by the generators, which produce the edges of every vortex in increasing index order: the tail of each list is tracked by the caller, so appending costs constant time. Indexes lower than the tail fall back to a sorted insertion, or to a weight update if the edge exists.
+     * 
+     * Does not update max_edge_weight, so several threads can append to different vortexes with their own pools.
+     * 
+     * @param Vortex The vortex to which the edge will be added.
+     * @param tail The last edge of the vortex's list, nullptr if the list is empty. Updated when the edge is appended.
+     * @param vortex_index_to The index of the target vortex.
+     * @param edge_weight The weight of the edge.
+     * @param pool The pool new edges are taken from.
+     */
+    void append_edge_private(vortex &Vortex, edge *&tail, unsigned int vortex_index_to, unsigned int edge_weight, node_pool<edge> &pool);
+
+    /**
+     * @brief Adds or updates a generated edge between two existing vortexes, through append_edge_private().
+     *
+     * Keeps both half edges with symmetric storage, the maximum edge weight and the components index up to date.
+     * 
+     * @param low_vortex The lower index vortex.
+     * @param high_vortex The higher index vortex.
+     * @param weight The weight of the edge.
+     * @param tails Tails of the lists, from collect_edge_tails().
+     */
+    void append_generated_edge(unsigned int low_vortex, unsigned int high_vortex, unsigned int weight, edge **tails);
+
+    /**
+     * @brief Multi-threaded G(n, p) generation, see generate_random_edges_gnp().
+     */
+    void generate_random_edges_gnp_parallel(double probability, unsigned long long seed, unsigned int thread_number);
+
+    /**
+     * @brief Returns an array with the last edge of every vortex index (nullptr for empty lists and missing vortexes), for append_edge_private().
+     *
+     * @return A dynamically allocated array of vortex_index_range elements, released by the caller with delete[].
+     */
+    edge **collect_edge_tails() const;
+
+    /**
+     * @brief Appends a vortex for every index from the current index range up to new_range - 1, in one pass.
+     *
+     * @param new_range The index range after the call, nothing is done if it is not bigger than the current one.
+     */
+    void extend_vortex_range(unsigned int new_range);
+
+    /**
+     * @brief Bulk builder: adds or updates a batch of edges between existing vortexes.
+     *
+     * The batch is sorted by (lower index, higher index) with a stable LSD radix sort and only the last copy of every repeated edge is kept, then every adjacency list receiving edges is merged with its part of the batch in a single walk. Keeps the symmetric half edges, the maximum edge weight and the components index up to date.
+     *
+     * @param edges The edges in insertion order, from_vortex lower than to_vortex, both existing. Sorted and compacted in place.
+     * @param edge_number Number of edges of the batch.
+     *
+     * @return The number of distinct edges applied, every repeated edge counted once.
+     */
+    unsigned long long merge_edge_batch(generated_half_edge *edges, unsigned long long edge_number);
+
+    /**
+     * @brief Merges half edges sorted by (from_vortex, to_vortex), without repetitions, into the lists of their from vortexes.
+     */
+    void merge_sorted_half_edges(const generated_half_edge *half_edges, unsigned long long half_edge_number);
 
     /**
      * @brief Private function to add an edge to a specific vortex.
@@ -195,36 +676,21 @@ private:
     void remove_edge_private(vortex &Vortex, unsigned int vortex_index_to);
 
     /**
-     * @brief Finds all reachable vortexes from a given base vortex using backtracking.
-     *
-     * This function uses backtracking to explore all reachable nodes from a given base node and stores the results in the provided array.
-     * 
-     * @param ptr Pointer to an array where reachability results will be stored.
-     * @param base_node The index of the base vortex.
+     * @brief Rebuilds the union-find connected components index from every edge of the graph.
      */
-    void full_reachable_vortexs(int *ptr, unsigned int base_node);
+    void build_component_index();
 
     /**
-     * @brief A helper function used in Dijkstra's algorithm to reach each vortex.
+     * @brief Returns the representative of the component of a vortex, halving the path on the way.
      *
-     * This function is used in the Dijkstra algorithm to explore each reachable vortex from the current node, updating the distance array.
-     * 
-     * @param current_node The current vortex being processed.
-     * @param current_distance_frombase The distance from the base node to the current vortex.
-     * @param distance_array The array storing the shortest distances to each vortex.
+     * @param vortex_index The index of the vortex, must be covered by the components index.
      */
-    void reach_vortex(unsigned int current_node, unsigned int current_distance_frombase, int *distance_array);
+    unsigned int find_component(unsigned int vortex_index);
 
     /**
-     * @brief Checks if all vortexes have been visited during Dijkstra's algorithm.
-     *
-     * This function checks whether all vortexes in the graph have been visited.
-     * 
-     * @param visited_vortex The array indicating whether each vortex has been visited.
-     * 
-     * @return 1 if all vortexes are visited, or 0 if some vortexes are unvisited.
+     * @brief Merges the components of two vortexes, attaching the smaller one to the bigger one.
      */
-    int check_all_vortex_visited(int *visited_vortex);
+    void union_components(unsigned int vortex1, unsigned int vortex2);
 };
 
 #endif
@@ -0,0 +1,86 @@
+#ifndef GRAPH_FILE_H
+#define GRAPH_FILE_H
+
+/**
+ * @file graph_file.h
+ * @brief Section helpers shared by the binary files of compressed_graph and contraction_hierarchy.
+ *
+ * @author Fernando Elena Benavente
+ *
+ * Both files are a fixed header followed by sections aligned to 8 bytes and zero padded, so they can be memory mapped and their arrays used in place. The checksum covers every byte after the header.
+ */
+
+#include <cstdio>
+#include <cstring>
+
+static const unsigned long long GRAPH_FILE_CHECKSUM_SEED = 14695981039346656037ULL; /**< Checksum of an empty file body. */
+
+/**
+ * @brief Rounds a size up to the 8 byte alignment of the sections.
+ */
+inline unsigned long long align_section(unsigned long long size)
+{
+    return (size + 7) & ~7ULL;
+}
+
+/**
+ * @brief Returns true if a section of size bytes at position lies inside a file of file_size bytes, without overflowing on corrupt headers.
+ */
+inline bool section_fits(unsigned long long position, unsigned long long size, unsigned long long file_size)
+{
+    return size <= file_size && position <= file_size - size;
+}
+
+/**
+ * @brief Returns true if row_number + 1 CSR offsets start at 0, never decrease and end at element_number.
+ */
+inline bool valid_row_offsets(const unsigned long long *offsets, unsigned int row_number, unsigned long long element_number)
+{
+    if (offsets[0] != 0 || offsets[row_number] != element_number)
+        return false;
+    for (unsigned int i = 0; i < row_number; ++i)
+        if (offsets[i + 1] < offsets[i])
+            return false;
+    return true;
+}
+
+/**
+ * @brief FNV-1a style hash over 64 bit words, the sections are 8 byte aligned and zero padded.
+ */
+inline unsigned long long graph_file_checksum(const unsigned char *data, unsigned long long size, unsigned long long hash = GRAPH_FILE_CHECKSUM_SEED)
+{
+    for (unsigned long long i = 0; i + 8 <= size; i += 8)
+    {
+        unsigned long long word;
+        memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Writes a section followed by the zero padding up to the next 8 byte boundary, updating the checksum.
+ *
+ * @return false if writing fails.
+ */
+inline bool write_section(FILE *file, const void *data, unsigned long long size, unsigned long long &checksum)
+{
+    static const unsigned char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    unsigned long long full_words = size & ~7ULL;
+    if (size > 0 && fwrite(data, 1, size, file) != size)
+        return false;
+    checksum = graph_file_checksum((const unsigned char *)data, full_words, checksum);
+
+    unsigned long long tail = size - full_words;
+    if (tail > 0)
+    {
+        unsigned char last_word[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        memcpy(last_word, (const unsigned char *)data + full_words, tail);
+        checksum = graph_file_checksum(last_word, 8, checksum);
+        if (fwrite(padding, 1, 8 - tail, file) != 8 - tail)
+            return false;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,233 @@
+#include <cmath>
+
+#include "graph.h"
+#include "dynamic_array.h"
+
+// uniform real in [0, 1) from the 53 high bits of the generator
+static double random_unit(mt19937_64 &generator)
+{
+	return (generator() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// R-MAT: every sample descends scale levels of the adjacency matrix, picking one quadrant per level,
+// the row and column bits of the chosen quadrants form the two vortex indexes. Nothing is kept per edge.
+int list_graph::generate_rmat_edges(unsigned long long edge_number, double a, double b, double c, unsigned long long seed)
+{
+	release_query_snapshot();
+	if (a < 0.0 || b < 0.0 || c < 0.0 || a + b + c > 1.0)
+		return -1;
+	if (this->vortex_index_range < 2)
+		return 0;
+
+	unsigned int scale = 0;
+	while ((1ULL << scale) < this->vortex_index_range)
+		++scale;
+
+	mt19937_64 generator(seed);
+	edge **tails = collect_edge_tails();
+	for (unsigned long long i = 0; i < edge_number; ++i)
+	{
+		unsigned long long row = 0, column = 0;
+		for (unsigned int level = 0; level < scale; ++level)
+		{
+			double quadrant = random_unit(generator);
+			row <<= 1;
+			column <<= 1;
+			if (quadrant < a)
+				; // top-left
+			else if (quadrant < a + b)
+				column |= 1; // top-right
+			else if (quadrant < a + b + c)
+				row |= 1; // bottom-left
+			else
+			{ // bottom-right
+				row |= 1;
+				column |= 1;
+			}
+		}
+		unsigned int weight = (generator() % 9) + 1;
+
+		if (row == column || find_vortex(row) == nullptr || find_vortex(column) == nullptr)
+			continue; // self loop or vortex not in the graph, the sample is dropped
+		if (row < column)
+			append_generated_edge(row, column, weight, tails);
+		else
+			append_generated_edge(column, row, weight, tails);
+	}
+	delete[] tails;
+	return 0;
+}
+
+// Barabasi-Albert: endpoints holds both vortexes of every generated edge, so a uniform pick from it is a
+// pick proportional to degree. Vortexes join in index order, so each new edge goes last on the list of its
+// lower index (older) vortex.
+int list_graph::generate_barabasi_albert_edges(unsigned int attach_edges, unsigned long long seed)
+{
+	release_query_snapshot();
+	if (attach_edges == 0 || this->vortex_number <= (int)attach_edges)
+		return -1;
+
+	mt19937_64 generator(seed);
+	edge **tails = collect_edge_tails();
+	dynamic_array<unsigned int> endpoints;
+	unsigned int *targets = new unsigned int[attach_edges];
+
+	// the first attach_edges vortexes are the initial targets, linked to the next one as a star
+	vortex *current_vortex = this->graph_head;
+	for (unsigned int i = 0; i < attach_edges; ++i)
+	{
+		targets[i] = current_vortex->vortex_index;
+		current_vortex = current_vortex->next;
+	}
+
+	while (current_vortex != nullptr)
+	{
+		unsigned int new_vortex = current_vortex->vortex_index;
+		for (unsigned int i = 0; i < attach_edges; ++i)
+		{
+			append_generated_edge(targets[i], new_vortex, (generator() % 9) + 1, tails);
+			endpoints.push_back(targets[i]);
+			endpoints.push_back(new_vortex);
+		}
+
+		// pick the distinct targets of the next vortex, proportional to degree
+		for (unsigned int i = 0; i < attach_edges; ++i)
+		{
+			bool repeated;
+			do
+			{
+				targets[i] = endpoints[generator() % endpoints.size()];
+				repeated = false;
+				for (unsigned int j = 0; j < i && !repeated; ++j)
+					repeated = targets[j] == targets[i];
+			} while (repeated);
+		}
+		current_vortex = current_vortex->next;
+	}
+
+	delete[] targets;
+	delete[] tails;
+	return 0;
+}
+
+// Random geometric graph: points are counting sorted by grid cell, cells are at least radius wide, so the
+// neighbors of a point closer than radius are all in its own cell or in the 8 around it.
+int list_graph::generate_geometric_edges(double radius, unsigned long long seed)
+{
+	release_query_snapshot();
+	if (!(radius > 0.0) || radius > 1.0)
+		return -1;
+	unsigned int vortex_index_range = this->vortex_index_range;
+	if (vortex_index_range < 2)
+		return 0;
+
+	// a point per vortex index, drawn even for removed indexes so the layout only depends on the seed
+	mt19937_64 generator(seed);
+	float *point_x = new float[vortex_index_range];
+	float *point_y = new float[vortex_index_range];
+	for (unsigned int i = 0; i < vortex_index_range; ++i)
+	{
+		point_x[i] = (float)random_unit(generator);
+		point_y[i] = (float)random_unit(generator);
+	}
+
+	// no more cells than vortexes, so the cell table stays within the per vortex memory
+	unsigned int cells_per_side = (unsigned int)(1.0 / radius);
+	unsigned int max_cells_per_side = (unsigned int)sqrt((double)vortex_index_range);
+	if (cells_per_side > max_cells_per_side)
+		cells_per_side = max_cells_per_side;
+	if (cells_per_side == 0)
+		cells_per_side = 1;
+	unsigned int cell_number = cells_per_side * cells_per_side;
+
+	auto cell_of = [&](unsigned int i) {
+		unsigned int cell_x = (unsigned int)(point_x[i] * cells_per_side);
+		unsigned int cell_y = (unsigned int)(point_y[i] * cells_per_side);
+		if (cell_x >= cells_per_side)
+			cell_x = cells_per_side - 1;
+		if (cell_y >= cells_per_side)
+			cell_y = cells_per_side - 1;
+		return cell_y * cells_per_side + cell_x;
+	};
+
+	unsigned int *cell_start = new unsigned int[cell_number + 1]();
+	unsigned int *cell_points = new unsigned int[vortex_index_range];
+	for (unsigned int i = 0; i < vortex_index_range; ++i)
+		if (find_vortex(i) != nullptr)
+			++cell_start[cell_of(i) + 1];
+	for (unsigned int i = 0; i < cell_number; ++i)
+		cell_start[i + 1] += cell_start[i];
+	for (unsigned int i = 0; i < vortex_index_range; ++i)
+		if (find_vortex(i) != nullptr)
+			cell_points[cell_start[cell_of(i)]++] = i;
+	for (unsigned int i = cell_number; i > 0; --i)
+		cell_start[i] = cell_start[i - 1]; // the fill moved every start to the next cell, shift them back
+	cell_start[0] = 0;
+
+	edge **tails = collect_edge_tails();
+	double squared_radius = radius * radius;
+	for (unsigned int i = 0; i < vortex_index_range; ++i)
+	{
+		if (find_vortex(i) == nullptr)
+			continue;
+		int cell = cell_of(i);
+		int cell_x = cell % cells_per_side, cell_y = cell / cells_per_side;
+		for (int neighbor_y = cell_y - 1; neighbor_y <= cell_y + 1; ++neighbor_y)
+		{
+			for (int neighbor_x = cell_x - 1; neighbor_x <= cell_x + 1; ++neighbor_x)
+			{
+				if (neighbor_x < 0 || neighbor_y < 0 || neighbor_x >= (int)cells_per_side || neighbor_y >= (int)cells_per_side)
+					continue;
+				unsigned int neighbor_cell = neighbor_y * cells_per_side + neighbor_x;
+				for (unsigned int k = cell_start[neighbor_cell]; k < cell_start[neighbor_cell + 1]; ++k)
+				{
+					unsigned int j = cell_points[k];
+					if (j <= i)
+						continue; // every pair is taken once, from its lower index
+					double delta_x = point_x[i] - point_x[j], delta_y = point_y[i] - point_y[j];
+					double squared_distance = delta_x * delta_x + delta_y * delta_y;
+					if (squared_distance >= squared_radius)
+						continue;
+					unsigned int weight = 1 + (unsigned int)(sqrt(squared_distance) / radius * 9.0);
+					append_generated_edge(i, j, weight > 9 ? 9 : weight, tails);
+				}
+			}
+		}
+	}
+
+	delete[] tails;
+	delete[] cell_start;
+	delete[] cell_points;
+	delete[] point_x;
+	delete[] point_y;
+	return 0;
+}
+
+// 2D grid: links every vortex to its right and bottom neighbors, in increasing index order
+int list_graph::generate_grid_edges(unsigned int width, unsigned int base_weight, unsigned int max_perturbation, unsigned long long seed)
+{
+	release_query_snapshot();
+	if (width == 0)
+		return -1;
+
+	mt19937_64 generator(seed);
+	edge **tails = collect_edge_tails();
+	auto perturbed_weight = [&]() {
+		long long weight = (long long)base_weight + (long long)(generator() % (2ULL * max_perturbation + 1)) - (long long)max_perturbation;
+		return weight < 1 ? 1u : (unsigned int)weight;
+	};
+
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+	{
+		unsigned int right_weight = perturbed_weight(), down_weight = perturbed_weight();
+		if (find_vortex(i) == nullptr)
+			continue;
+		unsigned long long right = (unsigned long long)i + 1, down = (unsigned long long)i + width;
+		if (right % width != 0 && right < this->vortex_index_range && find_vortex(right) != nullptr)
+			append_generated_edge(i, right, right_weight, tails);
+		if (down < this->vortex_index_range && find_vortex(down) != nullptr)
+			append_generated_edge(i, down, down_weight, tails);
+	}
+	delete[] tails;
+	return 0;
+}
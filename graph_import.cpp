@@ -0,0 +1,326 @@
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include "graph.h"
+#include "dynamic_array.h"
+
+static const unsigned long long IMPORT_CHUNK_BYTES = 64ULL << 20; // bytes read from the file at once
+
+// skips spaces, tabs and the carriage return of CRLF lines, never the newline
+static inline const char *skip_blanks(const char *cursor)
+{
+	while (*cursor == ' ' || *cursor == '\t' || *cursor == '\r')
+		++cursor;
+	return cursor;
+}
+
+// skips a word and the blanks after it
+static inline const char *skip_word(const char *cursor)
+{
+	while (*cursor != ' ' && *cursor != '\t' && *cursor != '\r' && *cursor != '\n')
+		++cursor;
+	return skip_blanks(cursor);
+}
+
+// reads a decimal number after optional blanks, returns nullptr if there is no digit or it overflows
+static inline const char *parse_unsigned(const char *cursor, unsigned long long &value)
+{
+	cursor = skip_blanks(cursor);
+	if (*cursor < '0' || *cursor > '9')
+		return nullptr;
+	value = 0;
+	while (*cursor >= '0' && *cursor <= '9')
+	{
+		if (value > (ULLONG_MAX - 9) / 10)
+			return nullptr;
+		value = value * 10 + (*cursor - '0');
+		++cursor;
+	}
+	return cursor;
+}
+
+// reads a Matrix Market value as a weight: integers with parse_unsigned(), anything else (sign, fraction,
+// exponent) with strtod, rounded to its absolute value and at least 1
+static inline const char *parse_matrix_value(const char *cursor, unsigned long long &weight)
+{
+	cursor = skip_blanks(cursor);
+	const char *integer_end = parse_unsigned(cursor, weight);
+	if (integer_end == nullptr || (*integer_end != ' ' && *integer_end != '\t' && *integer_end != '\r' && *integer_end != '\n'))
+	{
+		char *value_end;
+		double value = strtod(cursor, &value_end);
+		if (value_end == cursor || !(fabs(value) < 4294967295.0))
+			return nullptr;
+		weight = (unsigned long long)llround(fabs(value));
+		integer_end = value_end;
+	}
+	if (weight == 0)
+		weight = 1;
+	return integer_end;
+}
+
+// parses one line, which ends with a newline: returns 1 if it holds an edge, 0 for comments, headers, blank
+// lines and self loops, or -1 if it is malformed
+static int parse_edge_line(const char *line, graph_file_format format, generated_half_edge &parsed)
+{
+	unsigned long long first, second, weight = 1;
+	const char *cursor = skip_blanks(line);
+	if (*cursor == '\n')
+		return 0;
+
+	if (format == DIMACS_FILE)
+	{
+		if (*cursor == 'c' || *cursor == 'p')
+			return 0;
+		if (*cursor != 'a')
+			return -1;
+		cursor = parse_unsigned(cursor + 1, first);
+		cursor = cursor != nullptr ? parse_unsigned(cursor, second) : nullptr;
+		cursor = cursor != nullptr ? parse_unsigned(cursor, weight) : nullptr;
+	}
+	else if (format == EDGE_LIST_FILE)
+	{
+		if (*cursor == '#' || *cursor == '%')
+			return 0;
+		cursor = parse_unsigned(cursor, first);
+		cursor = cursor != nullptr ? parse_unsigned(cursor, second) : nullptr;
+		if (cursor != nullptr && *skip_blanks(cursor) != '\n')
+			cursor = parse_unsigned(cursor, weight); // the weight column is optional
+	}
+	else
+	{
+		if (*cursor == '%')
+			return 0;
+		cursor = parse_unsigned(cursor, first);
+		cursor = cursor != nullptr ? parse_unsigned(cursor, second) : nullptr;
+		if (cursor != nullptr && *skip_blanks(cursor) != '\n')
+			cursor = parse_matrix_value(cursor, weight); // pattern matrices have no value
+	}
+	if (cursor == nullptr)
+		return -1;
+
+	if (format != EDGE_LIST_FILE)
+	{ // 1-based indexes
+		if (first == 0 || second == 0)
+			return -1;
+		--first;
+		--second;
+	}
+	if (first >= UINT_MAX || second >= UINT_MAX || weight > UINT_MAX)
+		return -1;
+	if (first == second)
+		return 0; // self loops are dropped
+	parsed.from_vortex = first < second ? first : second;
+	parsed.to_vortex = first < second ? second : first;
+	parsed.edge_weight = weight;
+	return 1;
+}
+
+// parses the lines of [begin, end), end is right after a newline, and keeps the highest vortex index read
+static bool parse_edge_lines(const char *begin, const char *end, graph_file_format format, dynamic_array<generated_half_edge> &edges, unsigned long long &highest_index)
+{
+	generated_half_edge parsed;
+	const char *line = begin;
+	while (line < end)
+	{
+		int result = parse_edge_line(line, format, parsed);
+		if (result < 0)
+			return false;
+		if (result > 0)
+		{
+			edges.push_back(parsed);
+			if (parsed.to_vortex > highest_index)
+				highest_index = parsed.to_vortex;
+		}
+		line = (const char *)memchr(line, '\n', end - line) + 1;
+	}
+	return true;
+}
+
+// consumes the header lines at the start of [begin, end): the DIMACS problem line or the Matrix Market size line,
+// with the comments before them. Sets declared_vortexes, and header_pending to false once the header is read.
+static const char *parse_header(const char *begin, const char *end, graph_file_format format, unsigned long long &declared_vortexes, bool &header_pending)
+{
+	const char *line = begin;
+	while (line < end && header_pending)
+	{
+		const char *cursor = skip_blanks(line);
+		const char *next_line = (const char *)memchr(line, '\n', end - line) + 1;
+		unsigned long long rows, columns;
+		if (format == DIMACS_FILE)
+		{
+			if (*cursor == 'a')
+				break; // arcs before any problem line, nothing declared
+			if (*cursor == 'p' && parse_unsigned(skip_word(skip_word(cursor)), rows) != nullptr)
+			{
+				declared_vortexes = rows;
+				header_pending = false;
+			}
+		}
+		else if (*cursor != '%' && *cursor != '\n')
+		{ // the first line that is not a comment is the Matrix Market size line
+			cursor = parse_unsigned(cursor, rows);
+			cursor = cursor != nullptr ? parse_unsigned(cursor, columns) : nullptr;
+			if (cursor == nullptr)
+				break; // not a size line, left to the edge parser to report
+			declared_vortexes = rows > columns ? rows : columns;
+			header_pending = false;
+		}
+		line = next_line;
+	}
+	if (format == DIMACS_FILE && line < end && *skip_blanks(line) == 'a')
+		header_pending = false; // the edges started without a problem line
+	return header_pending && format == DIMACS_FILE ? begin : line;
+}
+
+// Streaming import. The file is read in chunks and each chunk is parsed up to its last newline, the partial
+// line left is carried to the front of the other buffer, where a reader thread appends the next chunk while
+// the parser threads work on the current one. Each parser thread takes a slice of the chunk cut at line
+// boundaries and fills its own edge array; the arrays are joined in file order, so the bulk builder sees the
+// edges in the order of the file and keeps the last copy of repeated edges.
+int list_graph::import_edges(const char *file_path, graph_file_format format, unsigned int thread_number)
+{
+	release_query_snapshot();
+	FILE *file = fopen(file_path, "rb");
+	if (file == nullptr)
+		return -1;
+	if (thread_number == 0)
+		thread_number = 1;
+
+	unsigned long long buffer_capacity = IMPORT_CHUNK_BYTES;
+	char *buffer = new char[buffer_capacity + 1]; // one more byte, for the newline closing the last line
+	char *next_buffer = new char[buffer_capacity + 1];
+	unsigned long long buffer_size = fread(buffer, 1, buffer_capacity, file);
+	bool end_of_file = buffer_size < buffer_capacity;
+
+	bool header_pending = format != EDGE_LIST_FILE;
+	unsigned long long declared_vortexes = 0;
+	dynamic_array<generated_half_edge> *slice_edges = new dynamic_array<generated_half_edge>[thread_number];
+	unsigned long long *slice_highest = new unsigned long long[thread_number];
+	bool *slice_valid = new bool[thread_number];
+	unsigned long long *slice_begin = new unsigned long long[thread_number + 1];
+	thread *parsers = new thread[thread_number];
+	dynamic_array<generated_half_edge> batch_edges;
+	int result = 0;
+
+	while (buffer_size > 0)
+	{
+		if (end_of_file && buffer[buffer_size - 1] != '\n')
+			buffer[buffer_size++] = '\n';
+		unsigned long long parse_size = buffer_size;
+		while (!end_of_file && parse_size > 0 && buffer[parse_size - 1] != '\n')
+			--parse_size;
+		if (parse_size == 0)
+		{ // a line longer than the buffers, grow them and read more of it
+			buffer_capacity *= 2;
+			char *grown_buffer = new char[buffer_capacity + 1];
+			memcpy(grown_buffer, buffer, buffer_size);
+			delete[] buffer;
+			delete[] next_buffer;
+			buffer = grown_buffer;
+			next_buffer = new char[buffer_capacity + 1];
+			unsigned long long read_size = fread(buffer + buffer_size, 1, buffer_capacity - buffer_size, file);
+			end_of_file = read_size < buffer_capacity - buffer_size;
+			buffer_size += read_size;
+			continue;
+		}
+
+		// carry the partial line and read the next chunk behind it while this one is parsed
+		unsigned long long carry_size = buffer_size - parse_size;
+		memcpy(next_buffer, buffer + parse_size, carry_size);
+		unsigned long long next_size = carry_size;
+		bool next_end_of_file = end_of_file;
+		thread reader;
+		if (!end_of_file)
+		{
+			reader = thread([&]() {
+				unsigned long long read_size = fread(next_buffer + carry_size, 1, buffer_capacity - carry_size, file);
+				next_size = carry_size + read_size;
+				next_end_of_file = read_size < buffer_capacity - carry_size;
+			});
+		}
+
+		unsigned long long parse_begin = 0;
+		if (header_pending)
+			parse_begin = parse_header(buffer, buffer + parse_size, format, declared_vortexes, header_pending) - buffer;
+
+		// slices of equal size, each moved forward to the start of a line
+		for (unsigned int t = 0; t <= thread_number; ++t)
+		{
+			slice_begin[t] = parse_begin + (parse_size - parse_begin) * t / thread_number;
+			if (t > 0 && t < thread_number)
+			{
+				if (slice_begin[t] < slice_begin[t - 1])
+					slice_begin[t] = slice_begin[t - 1];
+				while (slice_begin[t] > parse_begin && slice_begin[t] < parse_size && buffer[slice_begin[t] - 1] != '\n')
+					++slice_begin[t];
+			}
+		}
+		auto parse_slice = [&](unsigned int slice) {
+			slice_edges[slice].clear();
+			slice_highest[slice] = 0;
+			slice_valid[slice] = parse_edge_lines(buffer + slice_begin[slice], buffer + slice_begin[slice + 1], format, slice_edges[slice], slice_highest[slice]);
+		};
+		for (unsigned int t = 1; t < thread_number; ++t)
+			parsers[t] = thread(parse_slice, t);
+		parse_slice(0);
+		for (unsigned int t = 1; t < thread_number; ++t)
+			parsers[t].join();
+		if (reader.joinable())
+			reader.join();
+
+		// vortexes of the new indexes, then the edges of the chunk in file order
+		unsigned long long edge_number = 0, new_range = declared_vortexes;
+		for (unsigned int t = 0; t < thread_number; ++t)
+		{
+			if (!slice_valid[t])
+				result = -2;
+			edge_number += slice_edges[t].size();
+			if (!slice_edges[t].empty() && slice_highest[t] + 1 > new_range)
+				new_range = slice_highest[t] + 1;
+		}
+		if (new_range > UINT_MAX)
+			result = -2; // declared vortex count out of the index range
+		if (result < 0)
+			break;
+		extend_vortex_range(new_range);
+
+		batch_edges.resize(edge_number);
+		edge_number = 0;
+		for (unsigned int t = 0; t < thread_number; ++t)
+		{
+			for (unsigned long long i = 0; i < slice_edges[t].size(); ++i)
+			{
+				generated_half_edge &parsed = slice_edges[t][i];
+				if (find_vortex(parsed.from_vortex) == nullptr)
+					add_vortex(parsed.from_vortex); // index removed from the graph before the import
+				if (find_vortex(parsed.to_vortex) == nullptr)
+					add_vortex(parsed.to_vortex);
+			}
+			if (!slice_edges[t].empty())
+				memcpy(batch_edges.data() + edge_number, slice_edges[t].data(), slice_edges[t].size() * sizeof(generated_half_edge));
+			edge_number += slice_edges[t].size();
+		}
+		merge_edge_batch(batch_edges.data(), edge_number);
+
+		char *parsed_buffer = buffer;
+		buffer = next_buffer;
+		next_buffer = parsed_buffer;
+		buffer_size = next_size;
+		end_of_file = next_end_of_file;
+	}
+
+	fclose(file);
+	delete[] buffer;
+	delete[] next_buffer;
+	delete[] slice_edges;
+	delete[] slice_highest;
+	delete[] slice_valid;
+	delete[] slice_begin;
+	delete[] parsers;
+	return result;
+}
@@ -0,0 +1,1169 @@
+#ifndef GRAPH_SEARCH_H
+#define GRAPH_SEARCH_H
+
+/**
+ * @file graph_search.h
+ * @brief Search algorithms shared by list_graph and compressed_graph.
+ *
+ * @author Fernando Elena Benavente
+ *
+ * The algorithms are templates over the graph representation. A graph type only needs to provide get_vortex_index_range() and a for_each_neighbor(vortex_index, function) method that calls function(neighbor_index, edge_weight) once for every neighbor of the vortex. The parallel breadth first search and connected components also need any_neighbor(vortex_index, predicate), which stops at the first neighbor the predicate accepts.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+#include "dynamic_array.h"
+#include "search_context.h"
+#include "vortex_queue.h"
+
+using namespace std;
+
+/**
+ * @brief Returns the number of 64 bit words of a bitset with one bit per vortex index.
+ */
+inline unsigned int bitset_words(unsigned int vortex_index_range)
+{
+    return (vortex_index_range + 63) / 64;
+}
+
+/**
+ * @brief Returns true if the bit of a vortex is set.
+ */
+inline bool bitset_test(const unsigned long long *bitset, unsigned int vortex_index)
+{
+    return (bitset[vortex_index >> 6] >> (vortex_index & 63)) & 1;
+}
+
+/**
+ * @brief Sets the bit of a vortex.
+ */
+inline void bitset_set(unsigned long long *bitset, unsigned int vortex_index)
+{
+    bitset[vortex_index >> 6] |= 1ULL << (vortex_index & 63);
+}
+
+/**
+ * @brief Calls improved(neighbor_index, new_distance) for every neighbor whose distance in the context gets shorter through a vortex at vortex_distance.
+ *
+ * The relaxation step of the Dijkstra searches, over for_each_neighbor(). Graphs with contiguous rows overload it with the SIMD kernels of simd_kernels.h, see compressed_graph.h. Settled vortexes never get shorter, since weights are not negative.
+ */
+template <class Graph, class Function>
+void relax_neighbors(const Graph &graph, const search_context &context, unsigned int vortex_index, int vortex_distance, Function improved)
+{
+    graph.for_each_neighbor(vortex_index, [&](unsigned int neighbor, unsigned int edge_weight) {
+        int new_distance = vortex_distance + (int)edge_weight;
+        if (new_distance < context.get_distance(neighbor))
+            improved(neighbor, new_distance);
+    });
+}
+
+/**
+ * @brief Returns true if the bit of some neighbor of a vortex is set, over any_neighbor(). Overloaded with the SIMD kernels of simd_kernels.h like relax_neighbors().
+ */
+template <class Graph>
+bool any_neighbor_in_bitset(const Graph &graph, unsigned int vortex_index, const unsigned long long *bitset)
+{
+    return graph.any_neighbor(vortex_index, [&](unsigned int neighbor, unsigned int) { return bitset_test(bitset, neighbor); });
+}
+
+/**
+ * @brief Iterative breadth first search marking every vortex reachable from base_vortex.
+ *
+ * Each reached vortex is appended once to the frontier array, which is consumed in order as the BFS queue, so the search is linear in the reached vortexes and their edges and uses no recursion.
+ *
+ * @param graph The graph to search.
+ * @param base_vortex The index of the starting vortex.
+ * @param visited Bitset of bitset_words(get_vortex_index_range()) words, cleared by the caller. Output, the reached vortexes.
+ * @param frontier Array of get_vortex_index_range() elements. Output, the reached vortexes in BFS order.
+ *
+ * @return The number of reached vortexes, including base_vortex.
+ */
+template <class Graph>
+unsigned int breadth_first_search(const Graph &graph, unsigned int base_vortex, unsigned long long *visited, unsigned int *frontier)
+{
+    unsigned int frontier_begin = 0, frontier_end = 0;
+    bitset_set(visited, base_vortex);
+    frontier[frontier_end++] = base_vortex;
+
+    while (frontier_begin < frontier_end)
+    {
+        unsigned int current_node = frontier[frontier_begin++];
+        graph.for_each_neighbor(current_node, [&](unsigned int neighbor, unsigned int) {
+            if (!bitset_test(visited, neighbor))
+            {
+                bitset_set(visited, neighbor);
+                frontier[frontier_end++] = neighbor;
+            }
+        });
+    }
+    return frontier_end;
+}
+
+/**
+ * @brief Runs breadth_first_search() and returns the reachability array used by get_full_reachable_vortexs().
+ *
+ * @param graph The graph to search.
+ * @param base_vortex The index of the starting vortex, must be lower than the index range.
+ *
+ * @return A dynamically allocated array of get_vortex_index_range() elements, 0 on reachable vortexes and -1 on the rest.
+ */
+template <class Graph>
+int *reachable_vortexs_breadth_first(const Graph &graph, unsigned int base_vortex)
+{
+    unsigned int vortex_index_range = graph.get_vortex_index_range();
+    int *ptr = new int[vortex_index_range];
+    for (unsigned int i = 0; i < vortex_index_range; ptr[i++] = -1)
+        ;
+
+    unsigned long long *visited = new unsigned long long[bitset_words(vortex_index_range)]();
+    unsigned int *frontier = new unsigned int[vortex_index_range];
+    unsigned int reached = breadth_first_search(graph, base_vortex, visited, frontier);
+    for (unsigned int i = 0; i < reached; ++i)
+        ptr[frontier[i]] = 0;
+
+    delete[] visited;
+    delete[] frontier;
+    return ptr;
+}
+
+/**
+ * @brief Runs Dijkstra's algorithm from base_vortex until goal_vortex is settled or every reachable vortex is settled.
+ *
+ * The arrays must have get_vortex_index_range() elements, distance_frombase initialized to numeric_limits<int>::max(), predecessor to -1 and visited to false. The queue must be empty, and is left empty.
+ *
+ * @param graph The graph to search.
+ * @param base_vortex The index of the starting vortex.
+ * @param goal_vortex The index of the goal vortex, the search stops as soon as it is settled.
+ * @param queue The priority queue of vortexes (dary_heap or bucket_queue).
+ * @param distance_frombase Output, the distance to every settled or reached vortex.
+ * @param predecessor Output, the previous vortex on the shortest path to every reached vortex.
+ * @param visited Output, true on every settled vortex.
+ */
+template <class Graph, class Queue>
+void dijkstra_search(const Graph &graph, unsigned int base_vortex, unsigned int goal_vortex, Queue &queue,
+                     int *distance_frombase, int *predecessor, bool *visited)
+{
+    distance_frombase[base_vortex] = 0;
+    queue.push(base_vortex, 0);
+
+    unsigned int current_node;
+    int current_distance;
+    while (!queue.empty())
+    {
+        queue.pop(current_node, current_distance);
+        visited[current_node] = true;
+        if (current_node == goal_vortex)
+            break; // the goal is settled, its distance is final
+
+        graph.for_each_neighbor(current_node, [&](unsigned int neighbor, unsigned int edge_weight) {
+            int new_distance = current_distance + (int)edge_weight;
+            if (!visited[neighbor] && new_distance < distance_frombase[neighbor])
+            {
+                distance_frombase[neighbor] = new_distance;
+                predecessor[neighbor] = current_node;
+                queue.push(neighbor, new_distance);
+            }
+        });
+    }
+    queue.clear();
+}
+
+/**
+ * @brief Runs dijkstra_search() with the selected queue and prints the path found.
+ *
+ * Allocates the search arrays, prints the path from goal_vortex back to base_vortex (or that no path exists) and returns the distance.
+ *
+ * @param graph The graph to search.
+ * @param base_vortex The index of the starting vortex, must be lower than the index range.
+ * @param goal_vortex The index of the goal vortex, must be lower than the index range.
+ * @param queue_type The priority queue to use.
+ * @param max_edge_weight Upper bound of the edge weights, sizes the bucket queue.
+ *
+ * @return The shortest distance, or -1 if the goal vortex is not reachable.
+ */
+template <class Graph>
+int print_shortest_distance_dijkstra(const Graph &graph, unsigned int base_vortex, unsigned int goal_vortex,
+                                     dijkstra_queue queue_type, unsigned int max_edge_weight)
+{
+    unsigned int vortex_index_range = graph.get_vortex_index_range();
+    int *distance_frombase = new int[vortex_index_range];
+    int *predecessor = new int[vortex_index_range]; // Array to track predecessors
+    bool *visited = new bool[vortex_index_range](); // Track visited nodes
+
+    for (unsigned int i = 0; i < vortex_index_range; i++)
+    {
+        distance_frombase[i] = numeric_limits<int>::max(); // Initial distance to infinity
+        predecessor[i] = -1;                               // Initialize predecessors to -1
+    }
+
+    // Dial's buckets are only worth it for small weights, big ones use the heap
+    if (queue_type == BUCKET_QUEUE && max_edge_weight <= (1u << 20))
+    {
+        bucket_queue<int> queue(vortex_index_range, max_edge_weight);
+        dijkstra_search(graph, base_vortex, goal_vortex, queue, distance_frombase, predecessor, visited);
+    }
+    else
+    {
+        dary_heap<int> queue(vortex_index_range);
+        dijkstra_search(graph, base_vortex, goal_vortex, queue, distance_frombase, predecessor, visited);
+    }
+
+    int shortest_distance = distance_frombase[goal_vortex];
+
+    // Print the shortest path if reachable
+    if (shortest_distance != numeric_limits<int>::max())
+    {
+        cout << "Shortest path from " << base_vortex << " to " << goal_vortex << ": ";
+        int trace_node = goal_vortex;
+        while (trace_node != -1)
+        {
+            cout << trace_node;
+            trace_node = predecessor[trace_node];
+            if (trace_node != -1)
+                cout << " <- ";
+        }
+        cout << endl;
+    }
+    else
+    {
+        cout << "No path from " << base_vortex << " to " << goal_vortex << " found." << endl;
+    }
+
+    delete[] distance_frombase;
+    delete[] predecessor;
+    delete[] visited;
+    return shortest_distance != numeric_limits<int>::max() ? shortest_distance : -1;
+}
+
+/**
+ * @brief Copies the path of a finished search from its base to goal_vortex, following the predecessors of the context.
+ *
+ * @param context The buffers of the search.
+ * @param goal_vortex The end of the path.
+ * @param path Output, the vortexes of the path, base and goal included. Only written if the path fits.
+ * @param path_capacity Number of elements of path.
+ * @param path_length Output, the number of vortexes of the path (0 if the goal is not settled), also when it does not fit in path.
+ *
+ * @return The distance of goal_vortex, or -1 if it is not settled.
+ */
+inline int copy_search_path(const search_context &context, unsigned int goal_vortex, unsigned int *path, unsigned int path_capacity, unsigned int &path_length)
+{
+    path_length = 0;
+    if (!context.is_settled(goal_vortex))
+        return -1;
+    for (unsigned int trace_node = goal_vortex; trace_node != search_context::NO_PREDECESSOR; trace_node = context.get_predecessor(trace_node))
+        ++path_length;
+    if (path_length <= path_capacity)
+    { // the predecessors run from the goal back to the base, so the path is filled from its end
+        unsigned int position = path_length;
+        for (unsigned int trace_node = goal_vortex; trace_node != search_context::NO_PREDECESSOR; trace_node = context.get_predecessor(trace_node))
+            path[--position] = trace_node;
+    }
+    return context.get_distance(goal_vortex);
+}
+
+/**
+ * @brief Runs Dijkstra's algorithm from base_vortex until goal_vortex is settled, on the buffers of a search_context, and copies the path found.
+ *
+ * Nothing is allocated or printed: the context is reset lazily by begin_search(), so the search only touches the vortexes it reaches.
+ *
+ * @param graph The graph to search.
+ * @param context The buffers of the search, used by one thread at a time.
+ * @param base_vortex The index of the starting vortex, must exist.
+ * @param goal_vortex The index of the goal vortex, must exist.
+ * @param path Output, the vortexes of the path from base_vortex to goal_vortex, both included. Only written if the path fits.
+ * @param path_capacity Number of elements of path.
+ * @param path_length Output, the number of vortexes of the path (0 if there is no path), also when it does not fit in path.
+ *
+ * @return The shortest distance, or -1 if the goal vortex is not reachable.
+ */
+template <class Graph>
+int shortest_path_dijkstra(const Graph &graph, search_context &context, unsigned int base_vortex, unsigned int goal_vortex,
+                           unsigned int *path, unsigned int path_capacity, unsigned int &path_length)
+{
+    context.begin_search(graph.get_vortex_index_range());
+    dary_heap<int> &queue = context.get_queue();
+    context.set_reached(base_vortex, 0, search_context::NO_PREDECESSOR);
+    queue.push(base_vortex, 0);
+
+    unsigned int current_node;
+    int current_distance;
+    while (!queue.empty())
+    {
+        queue.pop(current_node, current_distance);
+        context.set_settled(current_node);
+        if (current_node == goal_vortex)
+            break; // the goal is settled, its distance is final
+
+        relax_neighbors(graph, context, current_node, current_distance, [&](unsigned int neighbor, int new_distance) {
+            context.set_reached(neighbor, new_distance, current_node);
+            queue.push(neighbor, new_distance);
+        });
+    }
+    queue.clear();
+    return copy_search_path(context, goal_vortex, path, path_capacity, path_length);
+}
+
+/**
+ * @brief Runs Dijkstra's algorithm from base_vortex until every reachable vortex is settled, on the buffers of a search_context.
+ *
+ * @param graph The graph to search.
+ * @param context The buffers of the search. Output, the distance of every vortex through get_distance(), numeric_limits<int>::max() on the unreachable ones.
+ * @param base_vortex The index of the starting vortex, must exist.
+ */
+template <class Graph>
+void dijkstra_all_distances(const Graph &graph, search_context &context, unsigned int base_vortex)
+{
+    context.begin_search(graph.get_vortex_index_range());
+    dary_heap<int> &queue = context.get_queue();
+    context.set_reached(base_vortex, 0, search_context::NO_PREDECESSOR);
+    queue.push(base_vortex, 0);
+
+    unsigned int current_node;
+    int current_distance;
+    while (!queue.empty())
+    {
+        queue.pop(current_node, current_distance);
+        context.set_settled(current_node);
+        relax_neighbors(graph, context, current_node, current_distance, [&](unsigned int neighbor, int new_distance) {
+            context.set_reached(neighbor, new_distance, current_node);
+            queue.push(neighbor, new_distance);
+        });
+    }
+}
+
+/**
+ * @brief A* search from base_vortex to goal_vortex on the buffers of a search_context, and copies the path found.
+ *
+ * Dijkstra's algorithm with the queue ordered by distance plus heuristic(vortex), a lower bound of the distance from the vortex to the goal, so the search is drawn towards the goal and settles fewer vortexes. The heuristic must be consistent (heuristic(u) <= edge weight + heuristic(v) for every edge), then every vortex is settled once with its final distance; a zero heuristic gives Dijkstra's search.
+ *
+ * @param graph The graph to search.
+ * @param context The buffers of the search, distances are kept without the heuristic.
+ * @param heuristic Callable taking a vortex index and returning an int lower bound of its distance to goal_vortex.
+ * @param base_vortex The index of the starting vortex, must exist.
+ * @param goal_vortex The index of the goal vortex, must exist.
+ * @param path Output, the vortexes of the path from base_vortex to goal_vortex, both included. Only written if the path fits.
+ * @param path_capacity Number of elements of path.
+ * @param path_length Output, the number of vortexes of the path (0 if there is no path), also when it does not fit in path.
+ *
+ * @return The shortest distance, or -1 if the goal vortex is not reachable.
+ */
+template <class Graph, class Heuristic>
+int astar_shortest_path(const Graph &graph, search_context &context, Heuristic heuristic, unsigned int base_vortex, unsigned int goal_vortex,
+                        unsigned int *path, unsigned int path_capacity, unsigned int &path_length)
+{
+    context.begin_search(graph.get_vortex_index_range());
+    dary_heap<int> &queue = context.get_queue();
+    context.set_reached(base_vortex, 0, search_context::NO_PREDECESSOR);
+    queue.push(base_vortex, heuristic(base_vortex));
+
+    unsigned int current_node;
+    int current_key;
+    while (!queue.empty())
+    {
+        queue.pop(current_node, current_key);
+        context.set_settled(current_node);
+        if (current_node == goal_vortex)
+            break; // the goal is settled, its distance is final
+
+        int current_distance = context.get_distance(current_node);
+        graph.for_each_neighbor(current_node, [&](unsigned int neighbor, unsigned int edge_weight) {
+            int new_distance = current_distance + (int)edge_weight;
+            if (!context.is_settled(neighbor) && new_distance < context.get_distance(neighbor))
+            {
+                context.set_reached(neighbor, new_distance, current_node);
+                queue.push(neighbor, new_distance + heuristic(neighbor));
+            }
+        });
+    }
+    queue.clear();
+    return copy_search_path(context, goal_vortex, path, path_capacity, path_length);
+}
+
+/**
+ * @brief Bidirectional Dijkstra: searches forward from base_vortex and backward from goal_vortex until the searches meet, and copies the path found.
+ *
+ * The graph is undirected, so both searches read the same neighbors. The side whose smallest queued distance is lower is expanded next, so both search balls grow at the same pace. Every edge scanned towards a vortex reached by the other side gives a candidate path length, and the best one, mu, is final once the smallest queued distances of both sides add up to mu or more: any path not seen yet would have to leave both balls. Each search only settles vortexes closer than about half the distance, instead of every vortex closer than the distance.
+ *
+ * @param graph The graph to search.
+ * @param forward_context The buffers of the search from base_vortex.
+ * @param backward_context The buffers of the search from goal_vortex, a different context.
+ * @param base_vortex The index of the starting vortex, must exist.
+ * @param goal_vortex The index of the goal vortex, must exist.
+ * @param path Output, the vortexes of the path from base_vortex to goal_vortex, both included. Only written if the path fits.
+ * @param path_capacity Number of elements of path.
+ * @param path_length Output, the number of vortexes of the path (0 if there is no path), also when it does not fit in path.
+ *
+ * @return The shortest distance, or -1 if the goal vortex is not reachable.
+ */
+template <class Graph>
+int bidirectional_shortest_path_dijkstra(const Graph &graph, search_context &forward_context, search_context &backward_context, unsigned int base_vortex, unsigned int goal_vortex,
+                                         unsigned int *path, unsigned int path_capacity, unsigned int &path_length)
+{
+    path_length = 0;
+    if (base_vortex == goal_vortex)
+    {
+        path_length = 1;
+        if (path_capacity > 0)
+            path[0] = base_vortex;
+        return 0;
+    }
+
+    unsigned int vortex_index_range = graph.get_vortex_index_range();
+    forward_context.begin_search(vortex_index_range);
+    backward_context.begin_search(vortex_index_range);
+    dary_heap<int> &forward_queue = forward_context.get_queue();
+    dary_heap<int> &backward_queue = backward_context.get_queue();
+    forward_context.set_reached(base_vortex, 0, search_context::NO_PREDECESSOR);
+    forward_queue.push(base_vortex, 0);
+    backward_context.set_reached(goal_vortex, 0, search_context::NO_PREDECESSOR);
+    backward_queue.push(goal_vortex, 0);
+
+    long long best_distance = numeric_limits<int>::max(); // mu, the shortest path seen through a meeting edge
+    unsigned int meeting_forward = search_context::NO_PREDECESSOR, meeting_backward = search_context::NO_PREDECESSOR;
+
+    // settles the closest vortex of one side, relaxes its edges and checks the vortexes the other side reached
+    auto expand = [&](search_context &own_context, search_context &other_context, dary_heap<int> &own_queue, bool forward_side) {
+        unsigned int current_node;
+        int current_distance;
+        own_queue.pop(current_node, current_distance);
+        own_context.set_settled(current_node);
+        graph.for_each_neighbor(current_node, [&](unsigned int neighbor, unsigned int edge_weight) {
+            int new_distance = current_distance + (int)edge_weight;
+            int other_distance = other_context.get_distance(neighbor);
+            if (other_distance != numeric_limits<int>::max() && (long long)new_distance + other_distance < best_distance)
+            {
+                best_distance = (long long)new_distance + other_distance;
+                meeting_forward = forward_side ? current_node : neighbor;
+                meeting_backward = forward_side ? neighbor : current_node;
+            }
+            if (!own_context.is_settled(neighbor) && new_distance < own_context.get_distance(neighbor))
+            {
+                own_context.set_reached(neighbor, new_distance, current_node);
+                own_queue.push(neighbor, new_distance);
+            }
+        });
+    };
+
+    while (!forward_queue.empty() && !backward_queue.empty())
+    {
+        if ((long long)forward_queue.top_key() + backward_queue.top_key() >= best_distance)
+            break; // no path through unsettled vortexes can be shorter than mu
+        if (forward_queue.top_key() <= backward_queue.top_key())
+            expand(forward_context, backward_context, forward_queue, true);
+        else
+            expand(backward_context, forward_context, backward_queue, false);
+    }
+    forward_queue.clear();
+    backward_queue.clear();
+
+    if (meeting_forward == search_context::NO_PREDECESSOR)
+        return -1;
+
+    // the forward predecessors lead from the meeting edge back to the base, the backward ones on to the goal
+    unsigned int forward_length = 0;
+    for (unsigned int trace_node = meeting_forward; trace_node != search_context::NO_PREDECESSOR; trace_node = forward_context.get_predecessor(trace_node))
+        ++forward_length;
+    path_length = forward_length;
+    for (unsigned int trace_node = meeting_backward; trace_node != search_context::NO_PREDECESSOR; trace_node = backward_context.get_predecessor(trace_node))
+        ++path_length;
+    if (path_length <= path_capacity)
+    {
+        unsigned int position = forward_length;
+        for (unsigned int trace_node = meeting_forward; trace_node != search_context::NO_PREDECESSOR; trace_node = forward_context.get_predecessor(trace_node))
+            path[--position] = trace_node;
+        position = forward_length;
+        for (unsigned int trace_node = meeting_backward; trace_node != search_context::NO_PREDECESSOR; trace_node = backward_context.get_predecessor(trace_node))
+            path[position++] = trace_node;
+    }
+    return (int)best_distance;
+}
+
+/**
+ * @brief Computes the shortest distance from every source to every target, running one Dijkstra search per source.
+ *
+ * Sources are taken in turns by thread_number worker threads (the calling thread is one of them). Each worker allocates its distance and settled arrays and its heap once, and after every search resets only the vortexes the search touched, so a search costs the part of the graph it explores, not the size of the graph. A search stops as soon as every target is settled.
+ *
+ * @param graph The graph to search.
+ * @param vortex_exists Callable taking a vortex index lower than the index range, true if the vortex exists.
+ * @param source_vortexs The source vortexes, one row of the matrix each.
+ * @param source_number Number of sources.
+ * @param target_vortexs The target vortexes, one column of the matrix each, repetitions allowed.
+ * @param target_number Number of targets.
+ * @param distance_matrix Output, source_number * target_number distances in row-major order, -1 when the target is not reachable or a vortex does not exist.
+ * @param thread_number Number of worker threads.
+ */
+template <class Graph, class Exists>
+void distance_matrix_dijkstra(const Graph &graph, Exists vortex_exists, const unsigned int *source_vortexs, unsigned int source_number,
+                              const unsigned int *target_vortexs, unsigned int target_number, int *distance_matrix, unsigned int thread_number)
+{
+    unsigned int vortex_index_range = graph.get_vortex_index_range();
+    bool *is_target = new bool[vortex_index_range]();
+    unsigned int distinct_targets = 0;
+    for (unsigned int j = 0; j < target_number; ++j)
+    {
+        unsigned int target = target_vortexs[j];
+        if (target < vortex_index_range && vortex_exists(target) && !is_target[target])
+        {
+            is_target[target] = true;
+            ++distinct_targets;
+        }
+    }
+
+    atomic<unsigned int> next_source(0);
+    auto search_sources = [&]() {
+        int *distance_frombase = new int[vortex_index_range];
+        bool *settled = new bool[vortex_index_range]();
+        for (unsigned int i = 0; i < vortex_index_range; ++i)
+            distance_frombase[i] = numeric_limits<int>::max();
+        dynamic_array<unsigned int> touched; // vortexes with a finite distance, reset after every search
+        dary_heap<int> queue(vortex_index_range);
+
+        for (unsigned int source = next_source++; source < source_number; source = next_source++)
+        {
+            int *distance_row = distance_matrix + (unsigned long long)source * target_number;
+            unsigned int base_vortex = source_vortexs[source];
+            if (base_vortex >= vortex_index_range || !vortex_exists(base_vortex))
+            {
+                for (unsigned int j = 0; j < target_number; ++j)
+                    distance_row[j] = -1;
+                continue;
+            }
+
+            unsigned int targets_left = distinct_targets;
+            distance_frombase[base_vortex] = 0;
+            touched.push_back(base_vortex);
+            queue.push(base_vortex, 0);
+            unsigned int current_node;
+            int current_distance;
+            while (!queue.empty() && targets_left > 0)
+            {
+                queue.pop(current_node, current_distance);
+                settled[current_node] = true;
+                if (is_target[current_node])
+                    --targets_left;
+                graph.for_each_neighbor(current_node, [&](unsigned int neighbor, unsigned int edge_weight) {
+                    int new_distance = current_distance + (int)edge_weight;
+                    if (!settled[neighbor] && new_distance < distance_frombase[neighbor])
+                    {
+                        if (distance_frombase[neighbor] == numeric_limits<int>::max())
+                            touched.push_back(neighbor);
+                        distance_frombase[neighbor] = new_distance;
+                        queue.push(neighbor, new_distance);
+                    }
+                });
+            }
+            queue.clear();
+
+            for (unsigned int j = 0; j < target_number; ++j)
+            {
+                unsigned int target = target_vortexs[j];
+                distance_row[j] = target < vortex_index_range && is_target[target] && settled[target] ? distance_frombase[target] : -1;
+            }
+            for (unsigned long long i = 0; i < touched.size(); ++i)
+            {
+                distance_frombase[touched[i]] = numeric_limits<int>::max();
+                settled[touched[i]] = false;
+            }
+            touched.clear();
+        }
+        delete[] distance_frombase;
+        delete[] settled;
+    };
+
+    if (thread_number == 0)
+        thread_number = 1;
+    if (thread_number > source_number)
+        thread_number = source_number > 0 ? source_number : 1;
+    thread *workers = new thread[thread_number];
+    for (unsigned int t = 1; t < thread_number; ++t)
+        workers[t] = thread(search_sources);
+    search_sources();
+    for (unsigned int t = 1; t < thread_number; ++t)
+        workers[t].join();
+    delete[] workers;
+    delete[] is_target;
+}
+
+/**
+ * @class phase_barrier
+ * @brief Reusable barrier of a fixed number of threads, the last thread to arrive runs a step alone before releasing the others.
+ */
+class phase_barrier
+{
+public:
+    phase_barrier(unsigned int thread_number)
+    {
+        this->thread_number = thread_number;
+        this->arrived = 0;
+        this->generation = 0;
+    }
+
+    /**
+     * @brief Waits until every thread arrives, the last one runs step() before the others continue.
+     */
+    template <class Step>
+    void arrive_and_wait(Step step)
+    {
+        unique_lock<mutex> lock(this->barrier_mutex);
+        unsigned long long arrival_generation = this->generation;
+        if (++this->arrived == this->thread_number)
+        {
+            step();
+            this->arrived = 0;
+            ++this->generation;
+            this->released.notify_all();
+            return;
+        }
+        this->released.wait(lock, [&]() { return this->generation != arrival_generation; });
+    }
+
+private:
+    unsigned int thread_number;    /**< Threads taking part. */
+    unsigned int arrived;          /**< Threads waiting in the current generation. */
+    unsigned long long generation; /**< Number of completed barriers. */
+    mutex barrier_mutex;
+    condition_variable released;
+};
+
+/**
+ * @brief Parallel delta-stepping single source shortest paths, computes the distance from base_vortex to every vortex.
+ *
+ * Vortexes are kept in buckets of width delta by tentative distance, and the buckets are processed in increasing order, every bucket in phases run by all threads at once. A phase takes the vortexes of the bucket found in the previous one and relaxes their light edges (weight up to delta), which can only add vortexes to the same bucket or later ones; when a phase adds none, the heavy edges of every vortex settled in the bucket are relaxed once. Distances are lowered with an atomic compare and swap minimum, so threads relax edges without locks, and a vortex lowered into a bucket is appended to a list of the thread that lowered it: the buckets are the union of those per thread lists, and a per vortex phase stamp makes sure each vortex is processed once per phase. Buckets live in a circular array of max_edge_weight / delta + 2 slots, since no relaxation reaches further. The distances are the same as Dijkstra's: a vortex is reprocessed whenever its distance is lowered, until its bucket is done.
+ *
+ * A small delta means few wasted relaxations but many phases, a big one few phases with more vortexes relaxed before their distance is final. delta = max_edge_weight makes every edge light.
+ *
+ * @param graph The graph to search, only read.
+ * @param base_vortex The index of the starting vortex, must exist.
+ * @param delta The bucket width, at least 1.
+ * @param max_edge_weight Upper bound of the edge weights.
+ * @param thread_number Number of threads, the calling thread is one of them.
+ * @param distance_frombase Output, array of get_vortex_index_range() elements, the distance to every vortex or numeric_limits<int>::max() if it is not reachable.
+ */
+template <class Graph>
+void delta_stepping_distances(const Graph &graph, unsigned int base_vortex, unsigned int delta, unsigned int max_edge_weight, unsigned int thread_number, int *distance_frombase)
+{
+    unsigned int vortex_index_range = graph.get_vortex_index_range();
+    if (delta == 0)
+        delta = 1;
+    if (thread_number == 0)
+        thread_number = 1;
+    unsigned int slot_number = max_edge_weight / delta + 2;
+
+    atomic<int> *distance = new atomic<int>[vortex_index_range];
+    atomic<unsigned int> *phase_stamp = new atomic<unsigned int>[vortex_index_range]; // last phase that processed the vortex
+    atomic<unsigned int> *heavy_stamp = new atomic<unsigned int>[vortex_index_range]; // last bucket, plus one, whose heavy edges it relaxed
+    for (unsigned int i = 0; i < vortex_index_range; ++i)
+    {
+        distance[i].store(numeric_limits<int>::max(), memory_order_relaxed);
+        phase_stamp[i].store(0, memory_order_relaxed);
+        heavy_stamp[i].store(0, memory_order_relaxed);
+    }
+
+    // per thread lists: bucket slots, vortexes found for the next phase of the bucket, and vortexes processed in the bucket
+    dynamic_array<unsigned int> *bucket_slots = new dynamic_array<unsigned int>[(unsigned long long)thread_number * slot_number];
+    dynamic_array<unsigned int> *phase_lists = new dynamic_array<unsigned int>[2 * thread_number];
+    dynamic_array<unsigned int> *settled_lists = new dynamic_array<unsigned int>[thread_number];
+    dynamic_array<unsigned int> **work_lists = new dynamic_array<unsigned int> *[thread_number]; // the lists of the current phase
+    unsigned long long *work_begin = new unsigned long long[thread_number + 1];                  // prefix sums of their sizes
+
+    distance[base_vortex].store(0, memory_order_relaxed);
+    bucket_slots[0].push_back(base_vortex);
+    unsigned long long current_bucket = 0;
+    unsigned int phase = 1, next_phase_list = 0;
+    bool heavy_phase = false, finished = false;
+    atomic<unsigned long long> next_item(0);
+    phase_barrier barrier(thread_number);
+
+    // points the work lists to the given lists of every thread and sums their sizes
+    auto set_work_lists = [&](dynamic_array<unsigned int> *lists, unsigned long long stride) {
+        work_begin[0] = 0;
+        for (unsigned int t = 0; t < thread_number; ++t)
+        {
+            work_lists[t] = lists + t * stride;
+            work_begin[t + 1] = work_begin[t] + work_lists[t]->size();
+        }
+        next_item.store(0, memory_order_relaxed);
+    };
+    set_work_lists(bucket_slots, slot_number);
+
+    // run by the last thread between phases: moves to the next phase of the bucket, its heavy phase, or the next bucket
+    auto plan_next_phase = [&]() {
+        ++phase;
+        unsigned int current_slot = current_bucket % slot_number;
+        if (!heavy_phase)
+        {
+            for (unsigned int t = 0; t < thread_number; ++t)
+                work_lists[t]->clear();
+            unsigned long long found = 0;
+            for (unsigned int t = 0; t < thread_number; ++t)
+                found += phase_lists[2 * t + next_phase_list].size();
+            if (found > 0)
+            { // the light edges lowered vortexes into the same bucket
+                set_work_lists(phase_lists + next_phase_list, 2);
+                next_phase_list ^= 1;
+                return;
+            }
+            heavy_phase = true;
+            set_work_lists(settled_lists, 1);
+            return;
+        }
+        for (unsigned int t = 0; t < thread_number; ++t)
+        {
+            settled_lists[t].clear();
+            bucket_slots[(unsigned long long)t * slot_number + current_slot].clear();
+        }
+        heavy_phase = false;
+        for (unsigned int step = 1; step < slot_number; ++step)
+        {
+            unsigned int slot = (current_bucket + step) % slot_number;
+            for (unsigned int t = 0; t < thread_number; ++t)
+            {
+                if (!bucket_slots[(unsigned long long)t * slot_number + slot].empty())
+                {
+                    current_bucket += step;
+                    set_work_lists(bucket_slots + slot, slot_number);
+                    return;
+                }
+            }
+        }
+        finished = true;
+    };
+
+    auto worker = [&](unsigned int thread_index) {
+        dynamic_array<unsigned int> *own_slots = bucket_slots + (unsigned long long)thread_index * slot_number;
+        while (true)
+        {
+            unsigned long long bucket = current_bucket;
+            long long bucket_end = (long long)(bucket + 1) * delta;
+            dynamic_array<unsigned int> &found_list = phase_lists[2 * thread_index + next_phase_list];
+
+            // lowers the distance of a vortex with a compare and swap loop, and files it in its bucket
+            auto relax = [&](unsigned int neighbor, int new_distance) {
+                int old_distance = distance[neighbor].load(memory_order_relaxed);
+                while (new_distance < old_distance)
+                {
+                    if (distance[neighbor].compare_exchange_weak(old_distance, new_distance, memory_order_relaxed))
+                    {
+                        if (new_distance < bucket_end)
+                            found_list.push_back(neighbor);
+                        else
+                            own_slots[((unsigned long long)new_distance / delta) % slot_number].push_back(neighbor);
+                        return;
+                    }
+                }
+            };
+
+            for (unsigned long long item = next_item.fetch_add(256); item < work_begin[thread_number]; item = next_item.fetch_add(256))
+            {
+                unsigned long long item_end = item + 256 < work_begin[thread_number] ? item + 256 : work_begin[thread_number];
+                unsigned int list = 0;
+                for (unsigned long long position = item; position < item_end; ++position)
+                {
+                    while (position >= work_begin[list + 1])
+                        ++list;
+                    unsigned int current_node = (*work_lists[list])[position - work_begin[list]];
+                    int current_distance = distance[current_node].load(memory_order_relaxed);
+                    if (heavy_phase)
+                    {
+                        if (heavy_stamp[current_node].exchange(bucket + 1, memory_order_relaxed) == bucket + 1)
+                            continue; // settled in several phases of the bucket, relaxed once
+                        graph.for_each_neighbor(current_node, [&](unsigned int neighbor, unsigned int edge_weight) {
+                            if (edge_weight > delta)
+                                relax(neighbor, current_distance + (int)edge_weight);
+                        });
+                        continue;
+                    }
+                    if ((unsigned long long)current_distance / delta != bucket)
+                        continue; // lowered into an earlier bucket after it was filed, already settled
+                    if (phase_stamp[current_node].exchange(phase, memory_order_relaxed) == phase)
+                        continue; // filed more than once, processed once per phase
+                    settled_lists[thread_index].push_back(current_node);
+                    graph.for_each_neighbor(current_node, [&](unsigned int neighbor, unsigned int edge_weight) {
+                        if (edge_weight <= delta)
+                            relax(neighbor, current_distance + (int)edge_weight);
+                    });
+                }
+            }
+            barrier.arrive_and_wait(plan_next_phase);
+            if (finished)
+                return;
+        }
+    };
+
+    thread *workers = new thread[thread_number];
+    for (unsigned int t = 1; t < thread_number; ++t)
+        workers[t] = thread(worker, t);
+    worker(0);
+    for (unsigned int t = 1; t < thread_number; ++t)
+        workers[t].join();
+
+    for (unsigned int i = 0; i < vortex_index_range; ++i)
+        distance_frombase[i] = distance[i].load(memory_order_relaxed);
+    delete[] workers;
+    delete[] work_begin;
+    delete[] work_lists;
+    delete[] settled_lists;
+    delete[] phase_lists;
+    delete[] bucket_slots;
+    delete[] heavy_stamp;
+    delete[] phase_stamp;
+    delete[] distance;
+}
+
+/**
+ * @brief Runs function(begin, end) on thread_number threads over chunks of chunk_size items of [0, item_number), and returns when every chunk is done.
+ *
+ * Chunks are claimed with an atomic counter, so threads that get cheap chunks take more of them. The calling thread is one of the threads.
+ */
+template <class Function>
+void parallel_for_chunks(unsigned int thread_number, unsigned int item_number, unsigned int chunk_size, Function function)
+{
+    if (thread_number == 0)
+        thread_number = 1;
+    atomic<unsigned int> next_item(0);
+    auto work = [&]() {
+        for (unsigned int begin = next_item.fetch_add(chunk_size); begin < item_number; begin = next_item.fetch_add(chunk_size))
+            function(begin, item_number - begin < chunk_size ? item_number : begin + chunk_size);
+    };
+    thread *workers = new thread[thread_number];
+    for (unsigned int t = 1; t < thread_number; ++t)
+        workers[t] = thread(work);
+    work();
+    for (unsigned int t = 1; t < thread_number; ++t)
+        workers[t].join();
+    delete[] workers;
+}
+
+/**
+ * @brief Direction-optimizing parallel breadth first search, marks every vortex reachable from base_vortex.
+ *
+ * Levels are expanded by thread_number threads in one of two directions. Top-down, the vortexes of the frontier list look at their neighbors and claim the unvisited ones with an atomic or on the visited bitset, every thread appending its claims to the next frontier list in blocks. Bottom-up, every unvisited vortex looks for a neighbor in the frontier bitmap and stops at the first one found (any_neighbor()), every thread owning whole 64 vortex words of the bitmaps so they are written without atomics. Bottom-up wins when the frontier is a big part of the unvisited graph, since most unvisited vortexes find a parent after a few neighbors, while top-down would scan every edge of the frontier. The search goes bottom-up when the next frontier is bigger than the unvisited vortexes divided by BOTTOM_UP_FRONTIER_SHARE, and back top-down when the frontier shrinks below the vortex index range divided by TOP_DOWN_FRONTIER_SHARE. Threads meet at a barrier between levels.
+ *
+ * The graph needs any_neighbor(vortex_index, predicate) besides for_each_neighbor(), and its edges must be readable from both ends.
+ *
+ * @param graph The graph to search, only read.
+ * @param vortex_exists Callable taking a vortex index and returning false for the indexes without a vortex, which are never read.
+ * @param base_vortex The index of the starting vortex, must exist.
+ * @param thread_number Number of threads, the calling thread is one of them.
+ * @param visited Bitset of bitset_words(get_vortex_index_range()) words. Output, the reached vortexes.
+ *
+ * @return The number of reached vortexes, including base_vortex.
+ */
+template <class Graph, class Exists>
+unsigned int parallel_breadth_first_search(const Graph &graph, Exists vortex_exists, unsigned int base_vortex, unsigned int thread_number, unsigned long long *visited)
+{
+    const unsigned int BOTTOM_UP_FRONTIER_SHARE = 14;
+    const unsigned int TOP_DOWN_FRONTIER_SHARE = 24;
+    const unsigned int TOP_DOWN_CHUNK = 64;   // frontier vortexes claimed at once
+    const unsigned int BOTTOM_UP_CHUNK = 16;  // bitmap words claimed at once
+    const unsigned int APPEND_BLOCK = 256;    // next frontier vortexes a thread collects before appending them
+
+    unsigned int vortex_index_range = graph.get_vortex_index_range();
+    unsigned int word_number = bitset_words(vortex_index_range);
+    if (thread_number == 0)
+        thread_number = 1;
+
+    atomic<unsigned long long> *visited_bits = new atomic<unsigned long long>[word_number];
+    for (unsigned int w = 0; w < word_number; ++w)
+        visited_bits[w].store(0, memory_order_relaxed);
+    unsigned long long *frontier_bits = new unsigned long long[word_number];
+    unsigned long long *next_bits = new unsigned long long[word_number];
+    unsigned int *frontier = new unsigned int[vortex_index_range];
+    unsigned int *next_frontier = new unsigned int[vortex_index_range];
+
+    visited_bits[base_vortex >> 6].store(1ULL << (base_vortex & 63), memory_order_relaxed);
+    frontier[0] = base_vortex;
+    unsigned int frontier_size = 1;
+    unsigned int reached_number = 1;
+    bool bottom_up = false;
+    bool finished = false;
+    atomic<unsigned int> next_item(0);
+    atomic<unsigned int> next_size(0);
+    phase_barrier barrier(thread_number);
+
+    // run by the last thread of every level: counts the new frontier, picks the direction of the next level and
+    // converts the frontier between list and bitmap when the direction changes
+    auto plan_next_level = [&]() {
+        unsigned int new_size = next_size.load(memory_order_relaxed);
+        reached_number += new_size;
+        next_size.store(0, memory_order_relaxed);
+        next_item.store(0, memory_order_relaxed);
+        if (new_size == 0)
+        {
+            finished = true;
+            return;
+        }
+        bool next_bottom_up = bottom_up;
+        if (!bottom_up && (unsigned long long)new_size * BOTTOM_UP_FRONTIER_SHARE > vortex_index_range - reached_number)
+            next_bottom_up = true;
+        else if (bottom_up && new_size < frontier_size && (unsigned long long)new_size * TOP_DOWN_FRONTIER_SHARE < vortex_index_range)
+            next_bottom_up = false;
+
+        if (!bottom_up && !next_bottom_up)
+        {
+            unsigned int *swap_list = frontier;
+            frontier = next_frontier;
+            next_frontier = swap_list;
+        }
+        else if (!bottom_up)
+        { // list to bitmap
+            memset(frontier_bits, 0, word_number * sizeof(unsigned long long));
+            for (unsigned int i = 0; i < new_size; ++i)
+                bitset_set(frontier_bits, next_frontier[i]);
+        }
+        else if (next_bottom_up)
+        {
+            unsigned long long *swap_bits = frontier_bits;
+            frontier_bits = next_bits;
+            next_bits = swap_bits;
+        }
+        else
+        { // bitmap to list
+            unsigned int position = 0;
+            for (unsigned int w = 0; w < word_number; ++w)
+            {
+                for (unsigned long long bits = next_bits[w]; bits != 0; bits &= bits - 1)
+                    frontier[position++] = (w << 6) + __builtin_ctzll(bits);
+            }
+        }
+        frontier_size = new_size;
+        bottom_up = next_bottom_up;
+    };
+
+    auto search_levels = [&]() {
+        unsigned int *claimed = new unsigned int[APPEND_BLOCK];
+        unsigned int claimed_number = 0;
+        auto append_claimed = [&]() {
+            unsigned int position = next_size.fetch_add(claimed_number, memory_order_relaxed);
+            memcpy(next_frontier + position, claimed, claimed_number * sizeof(unsigned int));
+            claimed_number = 0;
+        };
+
+        while (true)
+        {
+            if (!bottom_up)
+            {
+                for (unsigned int begin = next_item.fetch_add(TOP_DOWN_CHUNK); begin < frontier_size; begin = next_item.fetch_add(TOP_DOWN_CHUNK))
+                {
+                    unsigned int end = frontier_size - begin < TOP_DOWN_CHUNK ? frontier_size : begin + TOP_DOWN_CHUNK;
+                    for (unsigned int i = begin; i < end; ++i)
+                    {
+                        graph.for_each_neighbor(frontier[i], [&](unsigned int neighbor, unsigned int) {
+                            unsigned long long bit = 1ULL << (neighbor & 63);
+                            atomic<unsigned long long> &word = visited_bits[neighbor >> 6];
+                            if ((word.load(memory_order_relaxed) & bit) != 0 || (word.fetch_or(bit, memory_order_relaxed) & bit) != 0)
+                                return; // visited, or claimed by another thread first
+                            claimed[claimed_number++] = neighbor;
+                            if (claimed_number == APPEND_BLOCK)
+                                append_claimed();
+                        });
+                    }
+                }
+                append_claimed();
+            }
+            else
+            {
+                unsigned int found_number = 0;
+                for (unsigned int begin = next_item.fetch_add(BOTTOM_UP_CHUNK); begin < word_number; begin = next_item.fetch_add(BOTTOM_UP_CHUNK))
+                {
+                    unsigned int end = word_number - begin < BOTTOM_UP_CHUNK ? word_number : begin + BOTTOM_UP_CHUNK;
+                    for (unsigned int w = begin; w < end; ++w)
+                    {
+                        unsigned long long unvisited = ~visited_bits[w].load(memory_order_relaxed);
+                        if (w == word_number - 1 && (vortex_index_range & 63) != 0)
+                            unvisited &= (1ULL << (vortex_index_range & 63)) - 1; // no vortexes past the range
+                        unsigned long long found = 0;
+                        for (; unvisited != 0; unvisited &= unvisited - 1)
+                        {
+                            unsigned int bit_index = __builtin_ctzll(unvisited);
+                            unsigned int vortex_index = (w << 6) + bit_index;
+                            if (vortex_exists(vortex_index) && any_neighbor_in_bitset(graph, vortex_index, frontier_bits))
+                                found |= 1ULL << bit_index;
+                        }
+                        next_bits[w] = found;
+                        if (found != 0)
+                        {
+                            visited_bits[w].fetch_or(found, memory_order_relaxed);
+                            found_number += __builtin_popcountll(found);
+                        }
+                    }
+                }
+                next_size.fetch_add(found_number, memory_order_relaxed);
+            }
+            barrier.arrive_and_wait(plan_next_level);
+            if (finished)
+                break;
+        }
+        delete[] claimed;
+    };
+
+    thread *workers = new thread[thread_number];
+    for (unsigned int t = 1; t < thread_number; ++t)
+        workers[t] = thread(search_levels);
+    search_levels();
+    for (unsigned int t = 1; t < thread_number; ++t)
+        workers[t].join();
+    delete[] workers;
+
+    for (unsigned int w = 0; w < word_number; ++w)
+        visited[w] = visited_bits[w].load(memory_order_relaxed);
+    delete[] visited_bits;
+    delete[] frontier_bits;
+    delete[] next_bits;
+    delete[] frontier;
+    delete[] next_frontier;
+    return reached_number;
+}
+
+/**
+ * @brief Joins the trees of two vortexes in a concurrent union-find forest, hooking the higher root under the lower one with a compare and swap.
+ *
+ * Every parent is lower than or equal to its child, so the root of a tree is its lowest vortex index. Used by connected_component_labels().
+ */
+inline void link_component_trees(atomic<unsigned int> *parent, unsigned int vortex1, unsigned int vortex2)
+{
+    unsigned int parent1 = parent[vortex1].load(memory_order_relaxed);
+    unsigned int parent2 = parent[vortex2].load(memory_order_relaxed);
+    while (parent1 != parent2)
+    {
+        unsigned int high = parent1 > parent2 ? parent1 : parent2;
+        unsigned int low = parent1 + parent2 - high;
+        unsigned int high_parent = parent[high].load(memory_order_relaxed);
+        if (high_parent == low)
+            break;
+        if (high_parent == high && parent[high].compare_exchange_strong(high_parent, low, memory_order_relaxed))
+            break;
+        parent1 = parent[parent[high].load(memory_order_relaxed)].load(memory_order_relaxed);
+        parent2 = parent[low].load(memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Points every vortex of [begin, end) straight to the root of its tree.
+ */
+inline void compress_component_trees(atomic<unsigned int> *parent, unsigned int begin, unsigned int end)
+{
+    for (unsigned int i = begin; i < end; ++i)
+    {
+        while (parent[i].load(memory_order_relaxed) != parent[parent[i].load(memory_order_relaxed)].load(memory_order_relaxed))
+            parent[i].store(parent[parent[i].load(memory_order_relaxed)].load(memory_order_relaxed), memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Parallel connected components with the Afforest algorithm, labels every vortex with the lowest vortex index of its component.
+ *
+ * The components are the trees of a concurrent union-find forest (link_component_trees()). First every vortex is linked only to its first COMPONENT_SAMPLE_ROUNDS neighbors, which on most graphs already builds almost all of the giant component, and the forest is compressed. The most frequent root among COMPONENT_SAMPLE_SIZE sampled vortexes is taken as the giant component, and the last pass links the remaining neighbors of every vortex outside of it only: an edge between the giant component and another vortex is still seen from the other end, so the edges inside the giant component, most of the graph, are never read again. Every pass runs on thread_number threads over chunks of vortexes.
+ *
+ * The graph needs any_neighbor(vortex_index, predicate) besides for_each_neighbor(), and its edges must be readable from both ends.
+ *
+ * @param graph The graph to label, only read.
+ * @param vortex_exists Callable taking a vortex index and returning false for the indexes without a vortex, which are never read.
+ * @param thread_number Number of threads, the calling thread is one of them.
+ * @param component_label Output, array of get_vortex_index_range() elements, the lowest vortex index of the component of every vortex, numeric_limits<unsigned int>::max() on the indexes without a vortex.
+ *
+ * @return The number of connected components.
+ */
+template <class Graph, class Exists>
+unsigned int connected_component_labels(const Graph &graph, Exists vortex_exists, unsigned int thread_number, unsigned int *component_label)
+{
+    const unsigned int COMPONENT_SAMPLE_ROUNDS = 2;
+    const unsigned int COMPONENT_SAMPLE_SIZE = 1024;
+    const unsigned int CHUNK = 4096;
+
+    unsigned int vortex_index_range = graph.get_vortex_index_range();
+    atomic<unsigned int> *parent = new atomic<unsigned int>[vortex_index_range];
+    parallel_for_chunks(thread_number, vortex_index_range, CHUNK, [&](unsigned int begin, unsigned int end) {
+        for (unsigned int i = begin; i < end; ++i)
+            parent[i].store(i, memory_order_relaxed);
+    });
+
+    // sampling rounds, round r links every vortex to its r-th neighbor
+    for (unsigned int round = 0; round < COMPONENT_SAMPLE_ROUNDS; ++round)
+    {
+        parallel_for_chunks(thread_number, vortex_index_range, CHUNK, [&](unsigned int begin, unsigned int end) {
+            for (unsigned int i = begin; i < end; ++i)
+            {
+                if (!vortex_exists(i))
+                    continue;
+                unsigned int position = 0;
+                graph.any_neighbor(i, [&](unsigned int neighbor, unsigned int) {
+                    if (position++ < round)
+                        return false;
+                    link_component_trees(parent, i, neighbor);
+                    return true;
+                });
+            }
+        });
+        parallel_for_chunks(thread_number, vortex_index_range, CHUNK, [&](unsigned int begin, unsigned int end) {
+            compress_component_trees(parent, begin, end);
+        });
+    }
+
+    // the most frequent root of a sample of the vortexes, the giant component
+    unsigned int *sample = new unsigned int[COMPONENT_SAMPLE_SIZE];
+    unsigned int sample_number = 0;
+    unsigned long long random_state = 0x9E3779B97F4A7C15ULL;
+    for (unsigned int attempt = 0; attempt < 2 * COMPONENT_SAMPLE_SIZE && sample_number < COMPONENT_SAMPLE_SIZE && vortex_index_range > 0; ++attempt)
+    {
+        random_state = random_state * 6364136223846793005ULL + 1442695040888963407ULL;
+        unsigned int vortex_index = (unsigned int)((random_state >> 32) % vortex_index_range);
+        if (vortex_exists(vortex_index))
+            sample[sample_number++] = parent[vortex_index].load(memory_order_relaxed);
+    }
+    unsigned int giant_component = numeric_limits<unsigned int>::max();
+    unsigned int giant_count = 0;
+    for (unsigned int i = 0; i < sample_number; ++i)
+    {
+        unsigned int count = 0;
+        for (unsigned int j = i; j < sample_number; ++j)
+            count += sample[j] == sample[i];
+        if (count > giant_count)
+        {
+            giant_count = count;
+            giant_component = sample[i];
+        }
+    }
+    delete[] sample;
+
+    parallel_for_chunks(thread_number, vortex_index_range, CHUNK, [&](unsigned int begin, unsigned int end) {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            if (!vortex_exists(i) || parent[i].load(memory_order_relaxed) == giant_component)
+                continue;
+            unsigned int position = 0;
+            graph.for_each_neighbor(i, [&](unsigned int neighbor, unsigned int) {
+                if (position++ >= COMPONENT_SAMPLE_ROUNDS)
+                    link_component_trees(parent, i, neighbor);
+            });
+        }
+    });
+
+    atomic<unsigned int> component_number(0);
+    parallel_for_chunks(thread_number, vortex_index_range, CHUNK, [&](unsigned int begin, unsigned int end) {
+        compress_component_trees(parent, begin, end);
+        unsigned int roots = 0;
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            if (!vortex_exists(i))
+            {
+                component_label[i] = numeric_limits<unsigned int>::max();
+                continue;
+            }
+            component_label[i] = parent[i].load(memory_order_relaxed);
+            roots += component_label[i] == i;
+        }
+        component_number.fetch_add(roots, memory_order_relaxed);
+    });
+    delete[] parent;
+    return component_number.load();
+}
+
+#endif
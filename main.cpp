@@ -1,4 +1,5 @@
 #include "graph.h"
+#include "compressed_graph.h"
 
 // trivial testing main, atm just stupid machine
 int main()
@@ -33,5 +34,10 @@ int main()
 	int distance = migrafo.search_shortest_distance_dijkstra(0, 5);
 
 	cout << "distance between base vortex and goal vortex is : " << distance << endl;
+
+	compressed_graph *frozen = migrafo.freeze();
+	distance = frozen->search_shortest_distance_dijkstra(0, 5);
+	cout << "distance on the frozen graph is : " << distance << endl;
+	delete frozen;
 	return 0;
 }
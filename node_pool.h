@@ -0,0 +1,209 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+/**
+ * @file node_pool.h
+ * @brief Slab allocator for the fixed size nodes of the graph (edges and vortexes).
+ *
+ * @author Fernando Elena Benavente
+ *
+ * Allocating every edge and vortex with `new` costs a heap allocation per node, plus the allocator header of each block, and scatters the nodes of a graph across memory. The node_pool carves nodes out of big slabs instead: a slab holds many nodes back to back, removed nodes go to a free list and are reused by the next allocation, and every slab is released at once when the pool is destroyed, without visiting the nodes.
+ */
+
+#include <cstring>
+
+/**
+ * @class node_pool
+ * @brief Pool of fixed size nodes allocated from slabs, with a free list for reuse.
+ *
+ * The node type must be a plain struct at least as big as a pointer, free nodes store the free list link in their own memory.
+ *
+ * @tparam T The node type.
+ */
+template <typename T>
+class node_pool
+{
+public:
+    static const unsigned int MIN_SLAB_NODES = 64;      /**< Nodes in the first slab. */
+    static const unsigned int MAX_SLAB_NODES = 1 << 16; /**< Slabs double in size up to this number of nodes. */
+
+    node_pool()
+    {
+        this->slab_list = nullptr;
+        this->free_list = nullptr;
+        this->slab_cursor = nullptr;
+        this->slab_end = nullptr;
+        this->next_slab_nodes = MIN_SLAB_NODES;
+        this->nodes_in_use = 0;
+        this->nodes_reserved = 0;
+        this->slab_number = 0;
+    }
+
+    ~node_pool()
+    {
+        release_all();
+    }
+
+    node_pool(const node_pool &) = delete;
+    node_pool &operator=(const node_pool &) = delete;
+
+    /**
+     * @brief Returns an uninitialized node, reusing a released one if there is any.
+     */
+    T *allocate()
+    {
+        T *node;
+        if (this->free_list != nullptr)
+        {
+            node = this->free_list;
+            memcpy(&this->free_list, node, sizeof(T *));
+        }
+        else
+        {
+            if (this->slab_cursor == this->slab_end)
+                add_slab(this->next_slab_nodes);
+            node = this->slab_cursor++;
+        }
+        ++this->nodes_in_use;
+        return node;
+    }
+
+    /**
+     * @brief Gives a node back to the pool, it is reused by the next allocate().
+     */
+    void release(T *node)
+    {
+        memcpy(node, &this->free_list, sizeof(T *));
+        this->free_list = node;
+        --this->nodes_in_use;
+    }
+
+    /**
+     * @brief Makes sure the next node_number allocations do not need a new slab.
+     *
+     * Useful when the number of nodes is known in advance, such as the vortexes of a new graph: they are all placed in one slab.
+     */
+    void reserve(unsigned long long node_number)
+    {
+        unsigned long long available = this->slab_end - this->slab_cursor;
+        if (node_number > available)
+            add_slab(node_number);
+    }
+
+    /**
+     * @brief Takes over every slab of another pool, which is left empty.
+     *
+     * Lets worker threads allocate nodes from their own pools without locks, and hand them to a shared pool afterwards. Nodes allocated from the other pool stay valid and are now owned by this one. Costs the number of slabs plus the unused nodes of the other pool.
+     */
+    void absorb(node_pool &other)
+    {
+        while (other.slab_cursor != other.slab_end)
+        {
+            T *node = other.slab_cursor++;
+            memcpy(node, &this->free_list, sizeof(T *));
+            this->free_list = node;
+        }
+        while (other.free_list != nullptr)
+        {
+            T *node = other.free_list;
+            memcpy(&other.free_list, node, sizeof(T *));
+            memcpy(node, &this->free_list, sizeof(T *));
+            this->free_list = node;
+        }
+        while (other.slab_list != nullptr)
+        {
+            slab *moved_slab = other.slab_list;
+            other.slab_list = moved_slab->next_slab;
+            moved_slab->next_slab = this->slab_list;
+            this->slab_list = moved_slab;
+        }
+        this->nodes_in_use += other.nodes_in_use;
+        this->nodes_reserved += other.nodes_reserved;
+        this->slab_number += other.slab_number;
+
+        other.slab_cursor = nullptr;
+        other.slab_end = nullptr;
+        other.next_slab_nodes = MIN_SLAB_NODES;
+        other.nodes_in_use = 0;
+        other.nodes_reserved = 0;
+        other.slab_number = 0;
+    }
+
+    /**
+     * @brief Frees every slab at once. Every node given by the pool becomes invalid.
+     */
+    void release_all()
+    {
+        while (this->slab_list != nullptr)
+        {
+            slab *next_slab = this->slab_list->next_slab;
+            delete[] this->slab_list->nodes;
+            delete this->slab_list;
+            this->slab_list = next_slab;
+        }
+        this->free_list = nullptr;
+        this->slab_cursor = nullptr;
+        this->slab_end = nullptr;
+        this->next_slab_nodes = MIN_SLAB_NODES;
+        this->nodes_in_use = 0;
+        this->nodes_reserved = 0;
+        this->slab_number = 0;
+    }
+
+    /**
+     * @brief Returns the bytes of the nodes currently handed out.
+     */
+    unsigned long long bytes_used() const
+    {
+        return this->nodes_in_use * sizeof(T);
+    }
+
+    /**
+     * @brief Returns the bytes held by the pool: every slab, in use or not, plus the slab bookkeeping.
+     */
+    unsigned long long bytes_reserved() const
+    {
+        return this->nodes_reserved * sizeof(T) + this->slab_number * sizeof(slab);
+    }
+
+private:
+    struct slab
+    {
+        slab *next_slab; /**< Previously allocated slab. */
+        T *nodes;        /**< Node storage of this slab. */
+    };
+
+    slab *slab_list;                     /**< Every slab of the pool, newest first. */
+    T *free_list;                        /**< Released nodes, linked through their own memory. */
+    T *slab_cursor;                      /**< Next never used node of the newest slab. */
+    T *slab_end;                         /**< End of the newest slab. */
+    unsigned long long next_slab_nodes;  /**< Size of the next slab allocated on demand. */
+    unsigned long long nodes_in_use;     /**< Nodes handed out and not released. */
+    unsigned long long nodes_reserved;   /**< Nodes of every slab. */
+    unsigned long long slab_number;      /**< Number of slabs. */
+
+    // allocates a new slab for node_number nodes, the rest of the previous slab is given to the free list
+    void add_slab(unsigned long long node_number)
+    {
+        while (this->slab_cursor != this->slab_end)
+        {
+            T *node = this->slab_cursor++;
+            memcpy(node, &this->free_list, sizeof(T *));
+            this->free_list = node;
+        }
+
+        slab *new_slab = new slab;
+        new_slab->nodes = new T[node_number];
+        new_slab->next_slab = this->slab_list;
+        this->slab_list = new_slab;
+        this->slab_cursor = new_slab->nodes;
+        this->slab_end = new_slab->nodes + node_number;
+        this->nodes_reserved += node_number;
+        ++this->slab_number;
+
+        if (this->next_slab_nodes < MAX_SLAB_NODES)
+            this->next_slab_nodes *= 2;
+    }
+};
+
+#endif
@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <climits>
+
+#include "reordered_graph.h"
+#include "graph_search.h"
+
+// the ordering is computed on the source snapshot, then the rows are copied renumbered
+reordered_graph::reordered_graph(const compressed_graph &graph, vortex_order order)
+{
+	this->vortex_index_range = graph.get_vortex_index_range();
+	this->internal_index = compute_order(graph, order);
+	this->external_index = new unsigned int[this->vortex_index_range];
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+		this->external_index[this->internal_index[i]] = i;
+	this->internal_graph = new compressed_graph(graph, this->internal_index);
+}
+
+reordered_graph::~reordered_graph()
+{
+	delete this->internal_graph;
+	delete[] this->internal_index;
+	delete[] this->external_index;
+}
+
+//////////////////////////////////////PUBLIC METHODS////////////////////////////////////////////////////////////////
+
+unsigned int *reordered_graph::compute_order(const compressed_graph &graph, vortex_order order)
+{
+	unsigned int *new_index = new unsigned int[graph.get_vortex_index_range()];
+	if (order == DEGREE_ORDER)
+		degree_order(graph, new_index);
+	else
+		reverse_cuthill_mckee_order(graph, new_index);
+	return new_index;
+}
+
+const compressed_graph &reordered_graph::get_internal_graph() const
+{
+	return *this->internal_graph;
+}
+
+const unsigned int *reordered_graph::get_permutation() const
+{
+	return this->internal_index;
+}
+
+unsigned int reordered_graph::get_vortex_index_range() const
+{
+	return this->vortex_index_range;
+}
+
+unsigned long long reordered_graph::get_edge_number() const
+{
+	return this->internal_graph->get_edge_number();
+}
+
+unsigned int reordered_graph::get_degree(unsigned int vortex_index) const
+{
+	return this->internal_graph->get_degree(get_internal_index(vortex_index));
+}
+
+// out of range indexes are passed through, so the snapshot rejects them as usual
+int reordered_graph::search_shortest_path(search_context &context, unsigned int base_vortex, unsigned int goal_vortex, unsigned int *path, unsigned int path_capacity, unsigned int &path_length) const
+{
+	int distance = this->internal_graph->search_shortest_path(context, get_internal_index(base_vortex), get_internal_index(goal_vortex), path, path_capacity, path_length);
+	translate_path(path, path_capacity, path_length);
+	return distance;
+}
+
+int reordered_graph::search_shortest_path_bidirectional(search_context &forward_context, search_context &backward_context, unsigned int base_vortex, unsigned int goal_vortex, unsigned int *path, unsigned int path_capacity, unsigned int &path_length) const
+{
+	int distance = this->internal_graph->search_shortest_path_bidirectional(forward_context, backward_context, get_internal_index(base_vortex), get_internal_index(goal_vortex), path, path_capacity, path_length);
+	translate_path(path, path_capacity, path_length);
+	return distance;
+}
+
+// the matrix keeps the order of the sources and targets given, only their indexes are translated
+int *reordered_graph::search_distance_matrix(const unsigned int *source_vortexs, unsigned int source_number, const unsigned int *target_vortexs, unsigned int target_number, unsigned int thread_number) const
+{
+	unsigned int *internal_sources = new unsigned int[source_number];
+	unsigned int *internal_targets = new unsigned int[target_number];
+	for (unsigned int i = 0; i < source_number; ++i)
+		internal_sources[i] = get_internal_index(source_vortexs[i]);
+	for (unsigned int i = 0; i < target_number; ++i)
+		internal_targets[i] = get_internal_index(target_vortexs[i]);
+	int *distance_matrix = this->internal_graph->search_distance_matrix(internal_sources, source_number, internal_targets, target_number, thread_number);
+	delete[] internal_sources;
+	delete[] internal_targets;
+	return distance_matrix;
+}
+
+int *reordered_graph::search_all_distances(unsigned int base_vortex, unsigned int delta, unsigned int thread_number) const
+{
+	int *internal_distance = this->internal_graph->search_all_distances(get_internal_index(base_vortex), delta, thread_number);
+	int *distance_frombase = new int[this->vortex_index_range];
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+		distance_frombase[i] = internal_distance[this->internal_index[i]];
+	delete[] internal_distance;
+	return distance_frombase;
+}
+
+unsigned long long *reordered_graph::get_reachable_bitset(unsigned int base_vortex, unsigned int thread_number) const
+{
+	unsigned long long *internal_visited = this->internal_graph->get_reachable_bitset(get_internal_index(base_vortex), thread_number);
+	unsigned long long *visited = new unsigned long long[bitset_words(this->vortex_index_range)]();
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+		if (bitset_test(internal_visited, this->internal_index[i]))
+			bitset_set(visited, i);
+	delete[] internal_visited;
+	return visited;
+}
+
+// the internal labels are the lowest internal index of each component, relabeled with the lowest external index
+unsigned int *reordered_graph::get_component_labels(unsigned int &component_number, unsigned int thread_number) const
+{
+	unsigned int *internal_label = this->internal_graph->get_component_labels(component_number, thread_number);
+	unsigned int *lowest_external = new unsigned int[this->vortex_index_range];
+	for (unsigned int i = 0; i < this->vortex_index_range; lowest_external[i++] = UINT_MAX)
+		;
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i) // external indexes ascending, the first one seen is the lowest
+	{
+		unsigned int label = internal_label[this->internal_index[i]];
+		if (lowest_external[label] == UINT_MAX)
+			lowest_external[label] = i;
+	}
+	unsigned int *component_label = new unsigned int[this->vortex_index_range];
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+		component_label[i] = lowest_external[internal_label[this->internal_index[i]]];
+	delete[] lowest_external;
+	delete[] internal_label;
+	return component_label;
+}
+
+//////////////////////////////////////PRIVATE METHODS///////////////////////////////////////////////////////////////
+
+// Cuthill-McKee numbering per component, started from a pseudo-peripheral vortex (the lowest degree vortex of the
+// last level of a breadth first search from the lowest degree unnumbered vortex), and reversed at the end
+void reordered_graph::reverse_cuthill_mckee_order(const compressed_graph &graph, unsigned int *new_index)
+{
+	unsigned int vortex_index_range = graph.get_vortex_index_range();
+	unsigned int *visit_order = new unsigned int[vortex_index_range];
+	unsigned int *sweep_stamp = new unsigned int[vortex_index_range](); // vortexes seen by the peripheral sweep of a component
+	bool *numbered = new bool[vortex_index_range]();
+	unsigned int *by_degree = new unsigned int[vortex_index_range];
+	degree_order(graph, by_degree);
+	for (unsigned int i = 0; i < vortex_index_range; ++i)
+		visit_order[vortex_index_range - 1 - by_degree[i]] = i; // increasing degree, scratch use of visit_order
+	for (unsigned int i = 0; i < vortex_index_range; ++i)
+		by_degree[i] = visit_order[i];
+
+	auto lower_degree = [&](unsigned int first, unsigned int second) {
+		unsigned int first_degree = graph.get_degree(first), second_degree = graph.get_degree(second);
+		return first_degree < second_degree || (first_degree == second_degree && first < second);
+	};
+
+	unsigned int numbered_number = 0, component_number = 0;
+	for (unsigned int k = 0; k < vortex_index_range; ++k)
+	{
+		unsigned int start_vortex = by_degree[k];
+		if (numbered[start_vortex])
+			continue;
+
+		// peripheral sweep, breadth first in the unused tail of visit_order
+		++component_number;
+		unsigned int *sweep_queue = visit_order + numbered_number;
+		unsigned int queue_end = 1, level_begin = 0;
+		sweep_queue[0] = start_vortex;
+		sweep_stamp[start_vortex] = component_number;
+		for (unsigned int head = 0; head < queue_end;)
+		{
+			level_begin = head;
+			for (unsigned int level_end = queue_end; head < level_end; ++head)
+			{
+				graph.for_each_neighbor(sweep_queue[head], [&](unsigned int neighbor, unsigned int) {
+					if (sweep_stamp[neighbor] != component_number)
+					{
+						sweep_stamp[neighbor] = component_number;
+						sweep_queue[queue_end++] = neighbor;
+					}
+				});
+			}
+		}
+		for (unsigned int i = level_begin; i < queue_end; ++i)
+			if (lower_degree(sweep_queue[i], start_vortex))
+				start_vortex = sweep_queue[i];
+
+		// Cuthill-McKee from the peripheral vortex, the neighbors of each vortex queued by increasing degree
+		numbered[start_vortex] = true;
+		visit_order[numbered_number++] = start_vortex;
+		for (unsigned int head = numbered_number - 1; head < numbered_number; ++head)
+		{
+			unsigned int children_begin = numbered_number;
+			graph.for_each_neighbor(visit_order[head], [&](unsigned int neighbor, unsigned int) {
+				if (!numbered[neighbor])
+				{
+					numbered[neighbor] = true;
+					visit_order[numbered_number++] = neighbor;
+				}
+			});
+			sort(visit_order + children_begin, visit_order + numbered_number, lower_degree);
+		}
+	}
+
+	for (unsigned int i = 0; i < vortex_index_range; ++i)
+		new_index[visit_order[i]] = vortex_index_range - 1 - i;
+	delete[] visit_order;
+	delete[] sweep_stamp;
+	delete[] numbered;
+	delete[] by_degree;
+}
+
+// counting sort by degree, from the highest degree down
+void reordered_graph::degree_order(const compressed_graph &graph, unsigned int *new_index)
+{
+	unsigned int vortex_index_range = graph.get_vortex_index_range();
+	unsigned int max_degree = 0;
+	for (unsigned int i = 0; i < vortex_index_range; ++i)
+		if (graph.get_degree(i) > max_degree)
+			max_degree = graph.get_degree(i);
+
+	unsigned int *degree_position = new unsigned int[max_degree + 2](); // first new index of every degree
+	for (unsigned int i = 0; i < vortex_index_range; ++i)
+		++degree_position[max_degree - graph.get_degree(i) + 1];
+	for (unsigned int d = 0; d <= max_degree; ++d)
+		degree_position[d + 1] += degree_position[d];
+	for (unsigned int i = 0; i < vortex_index_range; ++i)
+		new_index[i] = degree_position[max_degree - graph.get_degree(i)]++;
+	delete[] degree_position;
+}
+
+void reordered_graph::translate_path(unsigned int *path, unsigned int path_capacity, unsigned int path_length) const
+{
+	if (path_length > path_capacity)
+		return; // the path was not copied
+	for (unsigned int i = 0; i < path_length; ++i)
+		path[i] = this->external_index[path[i]];
+}
@@ -0,0 +1,156 @@
+#ifndef REORDERED_GRAPH_H
+#define REORDERED_GRAPH_H
+
+/**
+ * @file reordered_graph.h
+ * @brief Read-only graph with its vortexes renumbered for cache locality, queried with the original vortex indexes.
+ *
+ * @author Fernando Elena Benavente
+ *
+ * Vortex indexes come from the order the graph was built in (add_vortex(), add_edge(), the random generators), so the neighbors of a vortex are usually far from it and from each other in the CSR arrays, and every edge a search scans touches a different cache line of the distance and stamp arrays. A reordered_graph renumbers the vortexes of a compressed_graph so neighbors get close indexes, and keeps the permutation to translate indexes both ways:
+ *
+ * - REVERSE_CUTHILL_MCKEE_ORDER: breadth first numbering from a peripheral vortex of every component, visiting the neighbors of each vortex by increasing degree, then reversed. Neighbors end up in the same or adjacent levels, close together, which is the right order for meshes and road networks.
+ * - DEGREE_ORDER: decreasing degree. The hubs, which most edges point at, share the first cache lines, the right order for power law graphs.
+ *
+ * The query methods take and return the original (external) indexes and translate them at the boundary, so a reordered_graph replaces a compressed_graph in a query loop without other changes. The searches run on the renumbered (internal) snapshot.
+ */
+
+#include "compressed_graph.h"
+#include "search_context.h"
+
+/**
+ * @brief Vortex orderings of reordered_graph.
+ */
+enum vortex_order
+{
+    REVERSE_CUTHILL_MCKEE_ORDER, /**< Reverse Cuthill-McKee, for meshes and road networks. */
+    DEGREE_ORDER                 /**< Decreasing degree, for power law graphs. */
+};
+
+/**
+ * @class reordered_graph
+ * @brief CSR snapshot with renumbered vortexes, queried with the indexes of the graph it was built from.
+ */
+class reordered_graph
+{
+public:
+    /**
+     * @brief Computes an ordering of a snapshot and builds the renumbered copy.
+     *
+     * @param graph The snapshot to renumber, only read.
+     * @param order The ordering, reverse Cuthill-McKee by default.
+     */
+    reordered_graph(const compressed_graph &graph, vortex_order order = REVERSE_CUTHILL_MCKEE_ORDER);
+
+    /**
+     * @brief Destructor that frees the renumbered snapshot and the permutation.
+     */
+    ~reordered_graph();
+
+    reordered_graph(const reordered_graph &) = delete;
+    reordered_graph &operator=(const reordered_graph &) = delete;
+
+    /**
+     * @brief Computes an ordering of a snapshot without building the copy.
+     *
+     * @param graph The snapshot to order.
+     * @param order The ordering.
+     *
+     * @return A dynamically allocated permutation of get_vortex_index_range() elements, the new index of every vortex, to pass to the compressed_graph renumbering constructor. Released by the caller with delete[].
+     */
+    static unsigned int *compute_order(const compressed_graph &graph, vortex_order order);
+
+    /**
+     * @brief Returns the renumbered snapshot, to run the templates of graph_search.h on internal indexes directly.
+     */
+    const compressed_graph &get_internal_graph() const;
+
+    /**
+     * @brief Returns the permutation, get_vortex_index_range() internal indexes indexed by external index.
+     */
+    const unsigned int *get_permutation() const;
+
+    /**
+     * @brief Returns the internal index of an external vortex index, the index itself if it is out of range.
+     */
+    unsigned int get_internal_index(unsigned int vortex_index) const
+    {
+        return vortex_index < this->vortex_index_range ? this->internal_index[vortex_index] : vortex_index;
+    }
+
+    /**
+     * @brief Returns the external index of an internal vortex index, the index itself if it is out of range.
+     */
+    unsigned int get_external_index(unsigned int vortex_index) const
+    {
+        return vortex_index < this->vortex_index_range ? this->external_index[vortex_index] : vortex_index;
+    }
+
+    /**
+     * @brief Returns the size of the vortex index space, the same as the source snapshot.
+     */
+    unsigned int get_vortex_index_range() const;
+
+    /**
+     * @brief Returns the number of undirected edges.
+     */
+    unsigned long long get_edge_number() const;
+
+    /**
+     * @brief Returns the number of neighbors of an external vortex, 0 if the index is out of range.
+     */
+    unsigned int get_degree(unsigned int vortex_index) const;
+
+    /**
+     * @brief Same as compressed_graph::search_shortest_path(), with external indexes in the arguments and the path.
+     */
+    int search_shortest_path(search_context &context, unsigned int base_vortex, unsigned int goal_vortex, unsigned int *path, unsigned int path_capacity, unsigned int &path_length) const;
+
+    /**
+     * @brief Same as compressed_graph::search_shortest_path_bidirectional(), with external indexes in the arguments and the path.
+     */
+    int search_shortest_path_bidirectional(search_context &forward_context, search_context &backward_context, unsigned int base_vortex, unsigned int goal_vortex, unsigned int *path, unsigned int path_capacity, unsigned int &path_length) const;
+
+    /**
+     * @brief Same as compressed_graph::search_distance_matrix(), with external source and target indexes.
+     */
+    int *search_distance_matrix(const unsigned int *source_vortexs, unsigned int source_number, const unsigned int *target_vortexs, unsigned int target_number, unsigned int thread_number = 1) const;
+
+    /**
+     * @brief Same as compressed_graph::search_all_distances(), the distances indexed by external index.
+     */
+    int *search_all_distances(unsigned int base_vortex, unsigned int delta = 0, unsigned int thread_number = 1) const;
+
+    /**
+     * @brief Same as compressed_graph::get_reachable_bitset(), the bits indexed by external index.
+     */
+    unsigned long long *get_reachable_bitset(unsigned int base_vortex, unsigned int thread_number = 1) const;
+
+    /**
+     * @brief Same as compressed_graph::get_component_labels(), the labels are the lowest external index of every component.
+     */
+    unsigned int *get_component_labels(unsigned int &component_number, unsigned int thread_number = 1) const;
+
+private:
+    unsigned int vortex_index_range;   /**< Highest vortex index plus one. */
+    unsigned int *internal_index;      /**< Internal index of every external index, the permutation. */
+    unsigned int *external_index;      /**< External index of every internal index, the inverse permutation. */
+    compressed_graph *internal_graph;  /**< The renumbered snapshot. */
+
+    /**
+     * @brief Reverse Cuthill-McKee numbering, fills new_index.
+     */
+    static void reverse_cuthill_mckee_order(const compressed_graph &graph, unsigned int *new_index);
+
+    /**
+     * @brief Decreasing degree numbering, ties kept in index order, fills new_index.
+     */
+    static void degree_order(const compressed_graph &graph, unsigned int *new_index);
+
+    /**
+     * @brief Translates a path of internal indexes to external ones in place, if it was copied.
+     */
+    void translate_path(unsigned int *path, unsigned int path_capacity, unsigned int path_length) const;
+};
+
+#endif
@@ -0,0 +1,189 @@
+#ifndef SEARCH_CONTEXT_H
+#define SEARCH_CONTEXT_H
+
+/**
+ * @file search_context.h
+ * @brief Reusable buffers of the quiet shortest path queries, one context per query thread.
+ *
+ * @author Fernando Elena Benavente
+ *
+ * search_shortest_distance_dijkstra() allocates and initializes three arrays the size of the graph on every call, which is what a query of a few hundred vortexes ends up paying for. A search_context owns those arrays (distance, predecessor and settled state) and the heap, and is passed to every query run by the same thread, so they are allocated once.
+ *
+ * The arrays are never cleared between searches. Every vortex carries a stamp, and each search takes two new stamp values: a vortex whose stamp is older than the current search has not been reached, so its distance and predecessor are garbage and are read as infinity and none. Starting a search costs nothing, and only when the 32 bit stamp wraps around (every two billion searches) the stamps are reset.
+ */
+
+#include <cstring>
+#include <limits>
+
+#include "simd_kernels.h"
+#include "vortex_queue.h"
+
+/**
+ * @class search_context
+ * @brief Distance, predecessor and settled arrays plus the heap of a Dijkstra search, reset lazily with stamps.
+ *
+ * A context is not thread safe, each thread uses its own. It grows to the index range of the graph it is used with, and can be used with several graphs.
+ */
+class search_context
+{
+public:
+    /**
+     * @brief Creates a context, optionally sized for a vortex index range so the first search does not allocate.
+     *
+     * @param capacity Size of the vortex index space to allocate for.
+     */
+    search_context(unsigned int capacity = 0)
+    {
+        this->capacity = 0;
+        this->search_stamp = 0;
+        this->settled_number = 0;
+        this->vortex_stamp = nullptr;
+        this->distance_frombase = nullptr;
+        this->predecessor = nullptr;
+        this->queue = nullptr;
+        reserve(capacity);
+    }
+
+    ~search_context()
+    {
+        delete[] this->vortex_stamp;
+        delete[] this->distance_frombase;
+        delete[] this->predecessor;
+        delete this->queue;
+    }
+
+    search_context(const search_context &) = delete;
+    search_context &operator=(const search_context &) = delete;
+
+    /**
+     * @brief Starts a new search over a graph with the given index range, every vortex becomes unreached.
+     *
+     * @param vortex_index_range Size of the vortex index space of the graph.
+     */
+    void begin_search(unsigned int vortex_index_range)
+    {
+        reserve(vortex_index_range);
+        this->settled_number = 0;
+        this->search_stamp += 2;
+        if (this->search_stamp < 2)
+        { // the stamps wrapped around, old stamps could look current
+            memset(this->vortex_stamp, 0, this->capacity * sizeof(unsigned int));
+            this->search_stamp = 2;
+        }
+    }
+
+    /**
+     * @brief Returns the distance of a vortex in the current search, numeric_limits<int>::max() if it was not reached.
+     */
+    int get_distance(unsigned int vortex_index) const
+    {
+        return this->vortex_stamp[vortex_index] >= this->search_stamp ? this->distance_frombase[vortex_index] : std::numeric_limits<int>::max();
+    }
+
+    /**
+     * @brief Returns the previous vortex on the shortest path to a vortex, NO_PREDECESSOR for the base vortex and unreached vortexes.
+     */
+    unsigned int get_predecessor(unsigned int vortex_index) const
+    {
+        return this->vortex_stamp[vortex_index] >= this->search_stamp ? this->predecessor[vortex_index] : NO_PREDECESSOR;
+    }
+
+    /**
+     * @brief Returns true if the distance of the vortex is final in the current search.
+     */
+    bool is_settled(unsigned int vortex_index) const
+    {
+        return this->vortex_stamp[vortex_index] == this->search_stamp + 1;
+    }
+
+    /**
+     * @brief Records a tentative distance and predecessor, the vortex becomes reached.
+     */
+    void set_reached(unsigned int vortex_index, int distance, unsigned int previous_vortex)
+    {
+        this->vortex_stamp[vortex_index] = this->search_stamp;
+        this->distance_frombase[vortex_index] = distance;
+        this->predecessor[vortex_index] = previous_vortex;
+    }
+
+    /**
+     * @brief Marks a reached vortex as settled.
+     */
+    void set_settled(unsigned int vortex_index)
+    {
+        this->vortex_stamp[vortex_index] = this->search_stamp + 1;
+        ++this->settled_number;
+    }
+
+    /**
+     * @brief Finds the neighbors of a contiguous row whose distance gets shorter through a vortex at base_distance, with the SIMD kernel of simd_kernels.h.
+     *
+     * @param neighbors The neighbor indexes of the row, lower than the capacity.
+     * @param weights The edge weights of the row.
+     * @param count Number of neighbors of the row.
+     * @param base_distance Distance of the vortex of the row.
+     * @param improved Output, at least count elements, the positions in the row of the improved neighbors.
+     *
+     * @return The number of improved neighbors.
+     */
+    unsigned int filter_relaxations(const unsigned int *neighbors, const unsigned int *weights, unsigned int count, int base_distance, unsigned int *improved) const
+    {
+        return simd_filter_relaxations(neighbors, weights, count, base_distance, this->distance_frombase, this->vortex_stamp, this->search_stamp, improved);
+    }
+
+    /**
+     * @brief Returns the number of vortexes settled by the current search, the work it did.
+     */
+    unsigned int get_settled_number() const
+    {
+        return this->settled_number;
+    }
+
+    /**
+     * @brief Returns the heap of the context, empty between searches.
+     */
+    dary_heap<int> &get_queue()
+    {
+        return *this->queue;
+    }
+
+    /**
+     * @brief Returns the number of vortex indexes the context can hold without growing.
+     */
+    unsigned int get_capacity() const
+    {
+        return this->capacity;
+    }
+
+    static const unsigned int NO_PREDECESSOR = std::numeric_limits<unsigned int>::max(); /**< Predecessor of the base vortex and of unreached vortexes. */
+
+private:
+    unsigned int capacity;       /**< Vortex indexes covered by the arrays. */
+    unsigned int search_stamp;   /**< Stamp of reached vortexes in the current search, settled ones have search_stamp + 1. */
+    unsigned int settled_number; /**< Vortexes settled since begin_search(). */
+    unsigned int *vortex_stamp;  /**< Stamp of the last search that reached every vortex. */
+    int *distance_frombase;      /**< Tentative or final distance, valid when the stamp is current. */
+    unsigned int *predecessor;   /**< Previous vortex on the shortest path, valid when the stamp is current. */
+    dary_heap<int> *queue;       /**< Heap of the search, sized to the capacity. */
+
+    // grows the arrays to the index range, the stamps of the new arrays start at zero so nothing looks reached
+    void reserve(unsigned int new_capacity)
+    {
+        if (new_capacity <= this->capacity && this->queue != nullptr)
+            return;
+        if (new_capacity < this->capacity)
+            new_capacity = this->capacity;
+        delete[] this->vortex_stamp;
+        delete[] this->distance_frombase;
+        delete[] this->predecessor;
+        delete this->queue;
+        this->capacity = new_capacity;
+        this->vortex_stamp = new unsigned int[new_capacity]();
+        this->distance_frombase = new int[new_capacity];
+        this->predecessor = new unsigned int[new_capacity];
+        this->queue = new dary_heap<int>(new_capacity);
+        this->search_stamp = 0;
+    }
+};
+
+#endif
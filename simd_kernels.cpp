@@ -0,0 +1,206 @@
+#include <limits>
+
+#include "simd_kernels.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SIMD_KERNELS_X86 // the vector kernels and the processor check, scalar kernels only on other targets
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+//////////////////////////////////////SCALAR KERNELS////////////////////////////////////////////////////////////////
+
+static unsigned int filter_relaxations_scalar(const unsigned int *neighbors, const unsigned int *weights, unsigned int count, int base_distance,
+											  const int *distance, const unsigned int *stamp, unsigned int current_stamp, unsigned int *improved)
+{
+	unsigned int improved_number = 0;
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		unsigned int neighbor = neighbors[i];
+		int neighbor_distance = stamp[neighbor] >= current_stamp ? distance[neighbor] : numeric_limits<int>::max();
+		if (base_distance + (int)weights[i] < neighbor_distance)
+			improved[improved_number++] = i;
+	}
+	return improved_number;
+}
+
+static bool any_in_bitset_scalar(const unsigned int *neighbors, unsigned int count, const unsigned long long *bitset)
+{
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		if ((bitset[neighbors[i] >> 6] >> (neighbors[i] & 63)) & 1)
+			return true;
+	}
+	return false;
+}
+
+#ifdef SIMD_KERNELS_X86
+
+// the gathers take signed 32 bit indexes, so a block with an index of 2^31 or more goes through the scalar kernel
+static unsigned int filter_block_scalar(const unsigned int *neighbors, const unsigned int *weights, unsigned int block_begin, unsigned int block_size, int base_distance,
+										const int *distance, const unsigned int *stamp, unsigned int current_stamp, unsigned int *improved)
+{
+	unsigned int block_number = filter_relaxations_scalar(neighbors + block_begin, weights + block_begin, block_size, base_distance, distance, stamp, current_stamp, improved);
+	for (unsigned int j = 0; j < block_number; ++j)
+		improved[j] += block_begin; // the block positions are relative to block_begin
+	return block_number;
+}
+
+//////////////////////////////////////AVX2 KERNELS//////////////////////////////////////////////////////////////////
+
+// 8 neighbors per step, the improved lanes come out of a movemask and are written one by one
+__attribute__((target("avx2"))) static unsigned int filter_relaxations_avx2(const unsigned int *neighbors, const unsigned int *weights, unsigned int count, int base_distance,
+																			const int *distance, const unsigned int *stamp, unsigned int current_stamp, unsigned int *improved)
+{
+	const __m256i base = _mm256_set1_epi32(base_distance);
+	const __m256i current = _mm256_set1_epi32((int)current_stamp);
+	const __m256i unreached = _mm256_set1_epi32(numeric_limits<int>::max());
+	unsigned int improved_number = 0;
+	unsigned int i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256i index = _mm256_loadu_si256((const __m256i *)(neighbors + i));
+		if (_mm256_movemask_ps(_mm256_castsi256_ps(index)) != 0)
+		{
+			improved_number += filter_block_scalar(neighbors, weights, i, 8, base_distance, distance, stamp, current_stamp, improved + improved_number);
+			continue;
+		}
+		__m256i new_distance = _mm256_add_epi32(base, _mm256_loadu_si256((const __m256i *)(weights + i)));
+		__m256i vortex_stamp = _mm256_i32gather_epi32((const int *)stamp, index, 4);
+		__m256i vortex_distance = _mm256_i32gather_epi32(distance, index, 4);
+		__m256i reached = _mm256_cmpeq_epi32(_mm256_max_epu32(vortex_stamp, current), vortex_stamp); // stamp >= current, unsigned
+		vortex_distance = _mm256_blendv_epi8(unreached, vortex_distance, reached);
+		unsigned int mask = (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(vortex_distance, new_distance)));
+		for (; mask != 0; mask &= mask - 1)
+			improved[improved_number++] = i + __builtin_ctz(mask);
+	}
+	return improved_number + filter_block_scalar(neighbors, weights, i, count - i, base_distance, distance, stamp, current_stamp, improved + improved_number);
+}
+
+__attribute__((target("avx2"))) static bool any_in_bitset_avx2(const unsigned int *neighbors, unsigned int count, const unsigned long long *bitset)
+{
+	const __m256i low_bits = _mm256_set1_epi32(31);
+	const __m256i one = _mm256_set1_epi32(1);
+	unsigned int i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256i index = _mm256_loadu_si256((const __m256i *)(neighbors + i));
+		__m256i word = _mm256_i32gather_epi32((const int *)bitset, _mm256_srli_epi32(index, 5), 4); // 32 bit halves of the little endian words
+		__m256i bit = _mm256_and_si256(_mm256_srlv_epi32(word, _mm256_and_si256(index, low_bits)), one);
+		if (!_mm256_testz_si256(bit, bit))
+			return true;
+	}
+	return any_in_bitset_scalar(neighbors + i, count - i, bitset);
+}
+
+//////////////////////////////////////AVX-512 KERNELS///////////////////////////////////////////////////////////////
+
+// 16 neighbors per step, the positions of the improved lanes are written with a compress store
+__attribute__((target("avx512f"))) static unsigned int filter_relaxations_avx512(const unsigned int *neighbors, const unsigned int *weights, unsigned int count, int base_distance,
+																				 const int *distance, const unsigned int *stamp, unsigned int current_stamp, unsigned int *improved)
+{
+	const __m512i base = _mm512_set1_epi32(base_distance);
+	const __m512i current = _mm512_set1_epi32((int)current_stamp);
+	const __m512i unreached = _mm512_set1_epi32(numeric_limits<int>::max());
+	const __mmask16 all_lanes = 0xFFFF; // the masked forms of the intrinsics, the unmasked ones start from an undefined register
+	const __m512i lane = _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+	const __m512i zero = _mm512_setzero_si512();
+	unsigned int improved_number = 0;
+	unsigned int i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m512i index = _mm512_loadu_si512(neighbors + i);
+		if (_mm512_cmplt_epi32_mask(index, zero) != 0)
+		{
+			improved_number += filter_block_scalar(neighbors, weights, i, 16, base_distance, distance, stamp, current_stamp, improved + improved_number);
+			continue;
+		}
+		__m512i new_distance = _mm512_add_epi32(base, _mm512_loadu_si512(weights + i));
+		__mmask16 reached = _mm512_cmpge_epu32_mask(_mm512_mask_i32gather_epi32(unreached, all_lanes, index, stamp, 4), current);
+		__m512i vortex_distance = _mm512_mask_i32gather_epi32(unreached, reached, index, distance, 4); // unreached lanes are not loaded
+		__mmask16 mask = _mm512_cmpgt_epi32_mask(vortex_distance, new_distance);
+		_mm512_mask_compressstoreu_epi32(improved + improved_number, mask, _mm512_add_epi32(lane, _mm512_set1_epi32((int)i)));
+		improved_number += __builtin_popcount(mask);
+	}
+	return improved_number + filter_block_scalar(neighbors, weights, i, count - i, base_distance, distance, stamp, current_stamp, improved + improved_number);
+}
+
+__attribute__((target("avx512f"))) static bool any_in_bitset_avx512(const unsigned int *neighbors, unsigned int count, const unsigned long long *bitset)
+{
+	const __m512i low_bits = _mm512_set1_epi32(31);
+	const __m512i one = _mm512_set1_epi32(1);
+	const __mmask16 all_lanes = 0xFFFF;
+	unsigned int i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m512i index = _mm512_loadu_si512(neighbors + i);
+		__m512i word = _mm512_mask_i32gather_epi32(one, all_lanes, _mm512_maskz_srli_epi32(all_lanes, index, 5), bitset, 4);
+		if (_mm512_test_epi32_mask(_mm512_maskz_srlv_epi32(all_lanes, word, _mm512_and_si512(index, low_bits)), one) != 0)
+			return true;
+	}
+	return any_in_bitset_scalar(neighbors + i, count - i, bitset);
+}
+
+#endif
+
+//////////////////////////////////////DISPATCH//////////////////////////////////////////////////////////////////////
+
+static simd_level widest_supported_level()
+{
+#ifdef SIMD_KERNELS_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+		return SIMD_AVX512;
+	if (__builtin_cpu_supports("avx2"))
+		return SIMD_AVX2;
+#endif
+	return SIMD_SCALAR;
+}
+
+static simd_level current_level = widest_supported_level(); // checked once, when the program starts
+
+simd_level get_simd_level()
+{
+	return current_level;
+}
+
+simd_level set_simd_level(simd_level level)
+{
+	simd_level widest = widest_supported_level();
+	current_level = level < widest ? level : widest;
+	return current_level;
+}
+
+unsigned int simd_filter_relaxations(const unsigned int *neighbors, const unsigned int *weights, unsigned int count, int base_distance,
+									 const int *distance, const unsigned int *stamp, unsigned int current_stamp, unsigned int *improved)
+{
+#ifdef SIMD_KERNELS_X86
+	switch (current_level)
+	{
+	case SIMD_AVX512:
+		return filter_relaxations_avx512(neighbors, weights, count, base_distance, distance, stamp, current_stamp, improved);
+	case SIMD_AVX2:
+		return filter_relaxations_avx2(neighbors, weights, count, base_distance, distance, stamp, current_stamp, improved);
+	default:
+		break;
+	}
+#endif
+	return filter_relaxations_scalar(neighbors, weights, count, base_distance, distance, stamp, current_stamp, improved);
+}
+
+bool simd_any_in_bitset(const unsigned int *neighbors, unsigned int count, const unsigned long long *bitset)
+{
+#ifdef SIMD_KERNELS_X86
+	switch (current_level)
+	{
+	case SIMD_AVX512:
+		return any_in_bitset_avx512(neighbors, count, bitset);
+	case SIMD_AVX2:
+		return any_in_bitset_avx2(neighbors, count, bitset);
+	default:
+		break;
+	}
+#endif
+	return any_in_bitset_scalar(neighbors, count, bitset);
+}
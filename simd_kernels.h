@@ -0,0 +1,69 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+/**
+ * @file simd_kernels.h
+ * @brief Vectorized inner loops of the searches over contiguous adjacency rows, with AVX2 and AVX-512 versions picked at run time and a scalar fallback.
+ *
+ * @author Fernando Elena Benavente
+ *
+ * Over a CSR row, relaxing edges is the same few steps for every neighbor: load its index and the edge weight, gather its distance, add, compare. The kernels do them 8 (AVX2) or 16 (AVX-512) neighbors at a time with gathers, and return the positions of the neighbors that pass, so only those go through the scalar work that cannot be vectorized (the heap). The bottom-up step of the breadth first search is the same pattern over a bitmap: gather the frontier words of the neighbors and test their bits.
+ *
+ * The vector versions are compiled with function target attributes, so no compiler flag is needed and the program still runs on processors without them: the processor is checked when the program starts and the widest supported version is used. set_simd_level() forces a narrower one, to compare a vector path against the scalar one. On targets other than x86 with GCC or Clang only the scalar versions are compiled.
+ *
+ * The gathers take signed 32 bit indexes: a block of neighbors with an index of 2^31 or more is relaxed by the scalar loop instead, the bitset kernels shift the index before the gather and need no fallback.
+ */
+
+/**
+ * @brief Instruction sets of the kernels.
+ */
+enum simd_level
+{
+    SIMD_SCALAR, /**< Plain C++ loops. */
+    SIMD_AVX2,   /**< 8 neighbors per step. */
+    SIMD_AVX512  /**< 16 neighbors per step, AVX-512F. */
+};
+
+/**
+ * @brief Returns the instruction set the kernels use, the widest one the processor supports unless set_simd_level() narrowed it.
+ */
+simd_level get_simd_level();
+
+/**
+ * @brief Makes the kernels use an instruction set, or the widest supported one if the processor lacks it.
+ *
+ * Not thread safe with running searches, meant for tests and benchmarks.
+ *
+ * @return The instruction set actually used.
+ */
+simd_level set_simd_level(simd_level level);
+
+/**
+ * @brief Finds the neighbors of a row whose distance base_distance + weight improves.
+ *
+ * The distance of a neighbor is distance[neighbor] if stamp[neighbor] >= current_stamp, and numeric_limits<int>::max() otherwise, as in search_context.
+ *
+ * @param neighbors The neighbor indexes of the row.
+ * @param weights The edge weights of the row.
+ * @param count Number of neighbors of the row.
+ * @param base_distance Distance of the vortex of the row.
+ * @param distance Distance array indexed by vortex.
+ * @param stamp Stamp array indexed by vortex.
+ * @param current_stamp Stamps lower than this one mean unreached.
+ * @param improved Output, at least count elements, the positions in the row of the improved neighbors, in increasing order.
+ *
+ * @return The number of improved neighbors.
+ */
+unsigned int simd_filter_relaxations(const unsigned int *neighbors, const unsigned int *weights, unsigned int count, int base_distance,
+                                     const int *distance, const unsigned int *stamp, unsigned int current_stamp, unsigned int *improved);
+
+/**
+ * @brief Returns true if the bit of some neighbor of a row is set in a bitset of 64 bit words.
+ *
+ * @param neighbors The neighbor indexes of the row.
+ * @param count Number of neighbors of the row.
+ * @param bitset Bitset indexed by vortex, bit (i & 63) of word i / 64.
+ */
+bool simd_any_in_bitset(const unsigned int *neighbors, unsigned int count, const unsigned long long *bitset);
+
+#endif
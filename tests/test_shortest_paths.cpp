@@ -0,0 +1,231 @@
+#include <iostream>
+#include <limits>
+#include <random>
+
+#include "../alt_landmarks.h"
+#include "../compressed_graph.h"
+#include "../contraction_hierarchy.h"
+#include "../dynamic_shortest_paths.h"
+#include "../graph.h"
+#include "../graph_search.h"
+
+using namespace std;
+
+// checks every shortest path engine against dijkstra_all_distances() on small random graphs, with both storages of
+// list_graph; the paths are checked too, they must go from base to goal over edges whose weights add up to the
+// distance; returns nonzero on a mismatch
+
+const unsigned int VORTEX_NUMBER = 80;
+const unsigned int PATH_CAPACITY = VORTEX_NUMBER;
+const unsigned int UPDATE_NUMBER = 300;
+
+static unsigned int mismatch_number = 0;
+
+static void expect_distance(const char *engine, unsigned int base_vortex, unsigned int goal_vortex, int expected, int found)
+{
+	if (expected == found)
+		return;
+	cout << engine << ": distance from " << base_vortex << " to " << goal_vortex << " is " << found << ", expected " << expected << "\n";
+	++mismatch_number;
+}
+
+// the distances of dijkstra_all_distances(), -1 on the unreachable vortexes as the engines return them
+static void reference_distances(const compressed_graph &graph, search_context &context, unsigned int base_vortex, int *distance)
+{
+	dijkstra_all_distances(graph, context, base_vortex);
+	for (unsigned int i = 0; i < VORTEX_NUMBER; ++i)
+		distance[i] = context.get_distance(i) == numeric_limits<int>::max() ? -1 : context.get_distance(i);
+}
+
+// the weight of the edge, -1 if there is none
+static int edge_weight(const compressed_graph &graph, unsigned int vortex1, unsigned int vortex2)
+{
+	int weight = -1;
+	graph.for_each_neighbor(vortex1, [&](unsigned int neighbor, unsigned int neighbor_weight) {
+		if (neighbor == vortex2)
+			weight = neighbor_weight;
+	});
+	return weight;
+}
+
+static void expect_path(const char *engine, const compressed_graph &graph, unsigned int base_vortex, unsigned int goal_vortex, int distance,
+						const unsigned int *path, unsigned int path_length)
+{
+	if (distance < 0)
+	{
+		if (path_length != 0)
+		{
+			cout << engine << ": a path from " << base_vortex << " to " << goal_vortex << " without distance\n";
+			++mismatch_number;
+		}
+		return;
+	}
+	bool valid = path_length > 0 && path_length <= PATH_CAPACITY && path[0] == base_vortex && path[path_length - 1] == goal_vortex;
+	int path_distance = 0;
+	for (unsigned int i = 1; valid && i < path_length; ++i)
+	{
+		int weight = edge_weight(graph, path[i - 1], path[i]);
+		valid = weight >= 0;
+		path_distance += weight;
+	}
+	if (!valid || path_distance != distance)
+	{
+		cout << engine << ": wrong path from " << base_vortex << " to " << goal_vortex << "\n";
+		++mismatch_number;
+	}
+}
+
+// every 23rd vortex from 7 is removed from the random graphs, so some indexes have no vortex
+static bool is_removed(unsigned int vortex_index)
+{
+	return vortex_index >= 7 && (vortex_index - 7) % 23 == 0;
+}
+
+// a sparse random graph, some vortexes are not reachable
+static void build_random_graph(list_graph &graph, double probability, unsigned long long seed)
+{
+	graph.generate_random_edges_gnp(probability, seed, 1);
+	for (unsigned int i = 0; i < VORTEX_NUMBER; ++i)
+		if (is_removed(i))
+			graph.remove_vortex(i);
+}
+
+static void check_static_engines(list_graph &graph, const char *storage, unsigned long long seed)
+{
+	compressed_graph *snapshot = graph.freeze();
+	contraction_hierarchy hierarchy(*snapshot, 1);
+	contraction_hierarchy parallel_hierarchy(*snapshot, 3);
+	alt_landmarks landmarks(graph, 3, seed);
+	search_context context, forward_context, backward_context;
+	int distance[VORTEX_NUMBER];
+	unsigned int path[PATH_CAPACITY], path_length;
+	const unsigned int deltas[] = {0, 1, 4, 100};
+	const unsigned int thread_numbers[] = {1, 3};
+
+	for (unsigned int base_vortex = 0; base_vortex < VORTEX_NUMBER; ++base_vortex)
+	{
+		if (is_removed(base_vortex))
+			continue;
+		reference_distances(*snapshot, context, base_vortex, distance);
+
+		for (unsigned int delta : deltas)
+		{
+			for (unsigned int thread_number : thread_numbers)
+			{
+				int *list_distance = graph.search_all_distances(base_vortex, delta, thread_number);
+				int *snapshot_distance = snapshot->search_all_distances(base_vortex, delta, thread_number);
+				for (unsigned int goal_vortex = 0; goal_vortex < VORTEX_NUMBER; ++goal_vortex)
+				{
+					expect_distance(storage, base_vortex, goal_vortex, distance[goal_vortex], list_distance[goal_vortex]);
+					expect_distance("compressed_graph delta-stepping", base_vortex, goal_vortex, distance[goal_vortex], snapshot_distance[goal_vortex]);
+				}
+				delete[] list_distance;
+				delete[] snapshot_distance;
+			}
+		}
+
+		for (unsigned int goal_vortex = 0; goal_vortex < VORTEX_NUMBER; ++goal_vortex)
+		{
+			int expected = distance[goal_vortex];
+			int found = graph.search_shortest_path(context, base_vortex, goal_vortex, path, PATH_CAPACITY, path_length);
+			expect_distance("list_graph dijkstra", base_vortex, goal_vortex, expected, found);
+			expect_path("list_graph dijkstra", *snapshot, base_vortex, goal_vortex, found, path, path_length);
+
+			found = graph.search_shortest_path_bidirectional(forward_context, backward_context, base_vortex, goal_vortex, path, PATH_CAPACITY, path_length);
+			expect_distance("list_graph bidirectional", base_vortex, goal_vortex, expected, found);
+			expect_path("list_graph bidirectional", *snapshot, base_vortex, goal_vortex, found, path, path_length);
+
+			found = graph.search_shortest_path_alt(landmarks, context, base_vortex, goal_vortex, path, PATH_CAPACITY, path_length);
+			expect_distance("list_graph ALT", base_vortex, goal_vortex, expected, found);
+			expect_path("list_graph ALT", *snapshot, base_vortex, goal_vortex, found, path, path_length);
+
+			found = snapshot->search_shortest_path(context, base_vortex, goal_vortex, path, PATH_CAPACITY, path_length);
+			expect_distance("compressed_graph dijkstra", base_vortex, goal_vortex, expected, found);
+			expect_path("compressed_graph dijkstra", *snapshot, base_vortex, goal_vortex, found, path, path_length);
+
+			found = snapshot->search_shortest_path_bidirectional(forward_context, backward_context, base_vortex, goal_vortex, path, PATH_CAPACITY, path_length);
+			expect_distance("compressed_graph bidirectional", base_vortex, goal_vortex, expected, found);
+			expect_path("compressed_graph bidirectional", *snapshot, base_vortex, goal_vortex, found, path, path_length);
+
+			found = hierarchy.search_shortest_path(forward_context, backward_context, base_vortex, goal_vortex, path, PATH_CAPACITY, path_length);
+			expect_distance("contraction_hierarchy", base_vortex, goal_vortex, expected, found);
+			expect_path("contraction_hierarchy", *snapshot, base_vortex, goal_vortex, found, path, path_length);
+
+			found = parallel_hierarchy.search_shortest_path(forward_context, backward_context, base_vortex, goal_vortex, path, PATH_CAPACITY, path_length);
+			expect_distance("contraction_hierarchy, 3 threads", base_vortex, goal_vortex, expected, found);
+			expect_path("contraction_hierarchy, 3 threads", *snapshot, base_vortex, goal_vortex, found, path, path_length);
+		}
+	}
+	delete snapshot;
+}
+
+// random edge insertions, weight changes, edge removals and vortex removals and insertions, the trees compared
+// after every update with a search from scratch
+static void check_dynamic_engine(unsigned long long seed)
+{
+	list_graph graph(VORTEX_NUMBER, "dynamic", true);
+	build_random_graph(graph, 0.05, seed);
+	dynamic_shortest_paths paths(graph);
+	const unsigned int sources[] = {0, 1, 41};
+	for (unsigned int source : sources)
+		paths.add_source(source);
+
+	mt19937 random(seed);
+	search_context context;
+	int distance[VORTEX_NUMBER];
+	for (unsigned int update = 0; update < UPDATE_NUMBER; ++update)
+	{
+		unsigned int vortex1 = random() % VORTEX_NUMBER, vortex2 = random() % VORTEX_NUMBER;
+		switch (random() % 8)
+		{
+		case 0:
+			if (vortex1 != sources[0] && vortex1 != sources[1] && vortex1 != sources[2])
+				paths.remove_vortex(vortex1);
+			break;
+		case 1:
+			paths.add_vortex(vortex1);
+			break;
+		case 2:
+		case 3:
+		case 4:
+			paths.remove_edge(vortex1, vortex2);
+			break;
+		default:
+			if (vortex1 != vortex2)
+				paths.add_edge(vortex1, vortex2, 1 + random() % 9);
+			break;
+		}
+
+		compressed_graph *snapshot = graph.freeze();
+		for (unsigned int source = 0; source < 3; ++source)
+		{
+			reference_distances(*snapshot, context, sources[source], distance);
+			for (unsigned int i = 0; i < VORTEX_NUMBER; ++i)
+				expect_distance("dynamic_shortest_paths", sources[source], i, distance[i], paths.get_distance(source, i));
+		}
+		delete snapshot;
+	}
+}
+
+int main()
+{
+	const unsigned long long seeds[] = {1, 2, 3};
+	for (unsigned long long seed : seeds)
+	{
+		list_graph lower_index_graph(VORTEX_NUMBER, "lower index", false);
+		list_graph symmetric_graph(VORTEX_NUMBER, "symmetric", true);
+		build_random_graph(lower_index_graph, 0.05, seed);
+		build_random_graph(symmetric_graph, 0.05, seed);
+		check_static_engines(lower_index_graph, "list_graph delta-stepping, lower index storage", seed);
+		check_static_engines(symmetric_graph, "list_graph delta-stepping, symmetric storage", seed);
+		for (unsigned int i = 0; i + 1 < VORTEX_NUMBER; i += 9) // the queries of the changed graph must not use the snapshot cached before
+		{
+			lower_index_graph.add_edge(i, VORTEX_NUMBER - 1 - i, 1 + i % 9);
+			lower_index_graph.remove_edge(i, i + 1);
+		}
+		check_static_engines(lower_index_graph, "list_graph delta-stepping, lower index storage, changed", seed);
+		check_dynamic_engine(seed);
+	}
+	cout << (mismatch_number == 0 ? "shortest paths: ok\n" : "shortest paths: FAILED\n");
+	return mismatch_number == 0 ? 0 : 1;
+}
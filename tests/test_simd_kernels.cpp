@@ -0,0 +1,104 @@
+#include <iostream>
+#include <random>
+
+#include "../simd_kernels.h"
+
+using namespace std;
+
+// checks every vector level the processor supports against the scalar kernels, on random rows of every length up
+// to a few vector widths, so the blocks and the scalar tails are both covered; returns nonzero on a mismatch
+
+const unsigned int VORTEX_NUMBER = 4096;
+const unsigned int MAX_ROW_LENGTH = 70;
+const unsigned int ROW_NUMBER = 2000;
+
+static unsigned int check_filter_relaxations(simd_level level, mt19937 &random)
+{
+	static int distance[VORTEX_NUMBER];
+	static unsigned int stamp[VORTEX_NUMBER];
+	unsigned int neighbors[MAX_ROW_LENGTH], weights[MAX_ROW_LENGTH];
+	unsigned int scalar_improved[MAX_ROW_LENGTH], level_improved[MAX_ROW_LENGTH];
+	const unsigned int current_stamp = 7;
+	unsigned int mismatch_number = 0;
+	for (unsigned int i = 0; i < VORTEX_NUMBER; ++i)
+	{
+		distance[i] = random() % 1000;
+		stamp[i] = current_stamp - 1 + random() % 3; // unreached, reached in this search, or a higher stamp
+	}
+	for (unsigned int row = 0; row < ROW_NUMBER; ++row)
+	{
+		unsigned int count = row % (MAX_ROW_LENGTH + 1);
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			neighbors[i] = random() % VORTEX_NUMBER;
+			weights[i] = random() % 100;
+		}
+		int base_distance = random() % 1000;
+		set_simd_level(SIMD_SCALAR);
+		unsigned int scalar_number = simd_filter_relaxations(neighbors, weights, count, base_distance, distance, stamp, current_stamp, scalar_improved);
+		set_simd_level(level);
+		unsigned int level_number = simd_filter_relaxations(neighbors, weights, count, base_distance, distance, stamp, current_stamp, level_improved);
+		bool same = scalar_number == level_number;
+		for (unsigned int i = 0; same && i < scalar_number; ++i)
+			same = scalar_improved[i] == level_improved[i];
+		if (!same)
+		{
+			cout << "simd_filter_relaxations differs at level " << level << " on a row of " << count << " neighbors\n";
+			++mismatch_number;
+		}
+	}
+	return mismatch_number;
+}
+
+static unsigned int check_any_in_bitset(simd_level level, mt19937 &random)
+{
+	static unsigned long long bitset[VORTEX_NUMBER / 64];
+	unsigned int neighbors[MAX_ROW_LENGTH];
+	unsigned int mismatch_number = 0;
+	for (unsigned int row = 0; row < ROW_NUMBER; ++row)
+	{
+		unsigned int count = row % (MAX_ROW_LENGTH + 1);
+		for (unsigned int i = 0; i < VORTEX_NUMBER / 64; ++i)
+			bitset[i] = 0;
+		unsigned int set_number = random() % 4; // few bits, so rows with and without a hit are both common
+		for (unsigned int i = 0; i < set_number; ++i)
+		{
+			unsigned int vortex_index = random() % VORTEX_NUMBER;
+			bitset[vortex_index >> 6] |= 1ULL << (vortex_index & 63);
+		}
+		for (unsigned int i = 0; i < count; ++i)
+			neighbors[i] = random() % VORTEX_NUMBER;
+		if (count > 0 && random() % 2 == 0)
+		{
+			unsigned int vortex_index = neighbors[random() % count]; // a hit at a random position, in a block or in the tail
+			bitset[vortex_index >> 6] |= 1ULL << (vortex_index & 63);
+		}
+		set_simd_level(SIMD_SCALAR);
+		bool scalar_found = simd_any_in_bitset(neighbors, count, bitset);
+		set_simd_level(level);
+		if (simd_any_in_bitset(neighbors, count, bitset) != scalar_found)
+		{
+			cout << "simd_any_in_bitset differs at level " << level << " on a row of " << count << " neighbors\n";
+			++mismatch_number;
+		}
+	}
+	return mismatch_number;
+}
+
+int main()
+{
+	mt19937 random(12345);
+	simd_level widest = get_simd_level();
+	unsigned int mismatch_number = 0;
+	for (int level = SIMD_AVX2; level <= widest; ++level)
+	{
+		mismatch_number += check_filter_relaxations((simd_level)level, random);
+		mismatch_number += check_any_in_bitset((simd_level)level, random);
+		cout << "level " << level << " checked\n";
+	}
+	if (widest == SIMD_SCALAR)
+		cout << "no vector level supported, nothing to compare\n";
+	set_simd_level(widest);
+	cout << (mismatch_number == 0 ? "simd kernels: ok\n" : "simd kernels: FAILED\n");
+	return mismatch_number == 0 ? 0 : 1;
+}
@@ -0,0 +1,179 @@
+#include "varint_graph.h"
+#include "graph_search.h"
+
+// writes value as a varint at bytes, or only counts its bytes when bytes is nullptr
+static unsigned int write_varint(unsigned long long value, unsigned char *bytes)
+{
+	unsigned int size = 1;
+	for (; value >= 0x80; value >>= 7, ++size)
+	{
+		if (bytes != nullptr)
+			*bytes++ = (unsigned char)(value | 0x80);
+	}
+	if (bytes != nullptr)
+		*bytes = (unsigned char)value;
+	return size;
+}
+
+// finds the lowest weight and the bits of the weights, then the first pass sizes every row and the second one writes
+// the rows, each after its size
+varint_graph::varint_graph(const compressed_graph &graph)
+{
+	this->vortex_index_range = graph.get_vortex_index_range();
+	this->edge_number = graph.get_edge_number();
+	this->max_edge_weight = graph.get_max_edge_weight();
+	this->min_edge_weight = this->max_edge_weight;
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+	{
+		graph.for_each_neighbor(i, [&](unsigned int, unsigned int edge_weight) {
+			if (edge_weight < this->min_edge_weight)
+				this->min_edge_weight = edge_weight;
+		});
+	}
+	this->weight_bits = 0;
+	for (unsigned int weight_spread = this->max_edge_weight - this->min_edge_weight; weight_spread > 0; weight_spread >>= 1)
+		++this->weight_bits;
+	if (this->weight_bits > 31)
+		this->weight_bits = SEPARATE_WEIGHTS; // a 33 bit zigzag difference and 32 weight bits overflow the code
+
+	unsigned int block_number = (unsigned int)((this->vortex_index_range + (unsigned long long)ROW_BLOCK_SIZE - 1) >> ROW_BLOCK_SHIFT);
+	this->block_offsets = new unsigned long long[block_number > 0 ? block_number : 1];
+	unsigned long long *row_size = new unsigned long long[this->vortex_index_range];
+	this->row_byte_number = 0;
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+	{
+		if ((i & (ROW_BLOCK_SIZE - 1)) == 0)
+			this->block_offsets[i >> ROW_BLOCK_SHIFT] = this->row_byte_number;
+		row_size[i] = encode_row(graph, i, nullptr);
+		this->row_byte_number += write_varint(row_size[i], nullptr) + row_size[i];
+	}
+
+	this->row_bytes = new unsigned char[this->row_byte_number > 0 ? this->row_byte_number : 1];
+	unsigned char *position = this->row_bytes;
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+	{
+		position += write_varint(row_size[i], position);
+		position += encode_row(graph, i, position);
+	}
+	delete[] row_size;
+}
+
+varint_graph::~varint_graph()
+{
+	delete[] this->block_offsets;
+	delete[] this->row_bytes;
+}
+
+//////////////////////////////////////PUBLIC METHODS////////////////////////////////////////////////////////////////
+
+unsigned int varint_graph::get_vortex_index_range() const
+{
+	return this->vortex_index_range;
+}
+
+unsigned long long varint_graph::get_edge_number() const
+{
+	return this->edge_number;
+}
+
+unsigned int varint_graph::get_max_edge_weight() const
+{
+	return this->max_edge_weight;
+}
+
+unsigned int varint_graph::get_degree(unsigned int vortex_index) const
+{
+	if (vortex_index >= this->vortex_index_range)
+		return 0;
+	unsigned int degree = 0;
+	for_each_neighbor(vortex_index, [&](unsigned int, unsigned int) { ++degree; });
+	return degree;
+}
+
+unsigned long long varint_graph::get_memory_usage() const
+{
+	return ((this->vortex_index_range + (unsigned long long)ROW_BLOCK_SIZE - 1) >> ROW_BLOCK_SHIFT) * sizeof(unsigned long long) + this->row_byte_number;
+}
+
+// quiet Dijkstra through shortest_path_dijkstra(), decoding the rows on the fly
+int varint_graph::search_shortest_path(search_context &context, unsigned int base_vortex, unsigned int goal_vortex, unsigned int *path, unsigned int path_capacity, unsigned int &path_length) const
+{
+	path_length = 0;
+	if (base_vortex >= this->vortex_index_range || goal_vortex >= this->vortex_index_range)
+		return -1;
+	return shortest_path_dijkstra(*this, context, base_vortex, goal_vortex, path, path_capacity, path_length);
+}
+
+// forward and backward searches through bidirectional_shortest_path_dijkstra()
+int varint_graph::search_shortest_path_bidirectional(search_context &forward_context, search_context &backward_context, unsigned int base_vortex, unsigned int goal_vortex, unsigned int *path, unsigned int path_capacity, unsigned int &path_length) const
+{
+	path_length = 0;
+	if (base_vortex >= this->vortex_index_range || goal_vortex >= this->vortex_index_range)
+		return -1;
+	return bidirectional_shortest_path_dijkstra(*this, forward_context, backward_context, base_vortex, goal_vortex, path, path_capacity, path_length);
+}
+
+// delta-stepping through delta_stepping_distances(), unreachable vortexes become -1
+int *varint_graph::search_all_distances(unsigned int base_vortex, unsigned int delta, unsigned int thread_number) const
+{
+	int *distance_frombase = new int[this->vortex_index_range];
+	if (base_vortex >= this->vortex_index_range)
+	{
+		for (unsigned int i = 0; i < this->vortex_index_range; distance_frombase[i++] = -1)
+			;
+		return distance_frombase;
+	}
+	if (delta == 0)
+		delta = this->max_edge_weight > 0 ? this->max_edge_weight : 1;
+	delta_stepping_distances(*this, base_vortex, delta, this->max_edge_weight, thread_number, distance_frombase);
+	for (unsigned int i = 0; i < this->vortex_index_range; ++i)
+		if (distance_frombase[i] == numeric_limits<int>::max())
+			distance_frombase[i] = -1;
+	return distance_frombase;
+}
+
+// direction-optimizing breadth first search through parallel_breadth_first_search()
+unsigned long long *varint_graph::get_reachable_bitset(unsigned int base_vortex, unsigned int thread_number) const
+{
+	unsigned long long *visited = new unsigned long long[bitset_words(this->vortex_index_range)]();
+	if (base_vortex < this->vortex_index_range)
+		parallel_breadth_first_search(*this, [](unsigned int) { return true; }, base_vortex, thread_number, visited);
+	return visited;
+}
+
+// Afforest through connected_component_labels()
+unsigned int *varint_graph::get_component_labels(unsigned int &component_number, unsigned int thread_number) const
+{
+	unsigned int *component_label = new unsigned int[this->vortex_index_range];
+	component_number = connected_component_labels(*this, [](unsigned int) { return true; }, thread_number, component_label);
+	return component_label;
+}
+
+//////////////////////////////////////PRIVATE METHODS///////////////////////////////////////////////////////////////
+
+// the first neighbor is a zigzag encoded signed difference to the vortex index, the next ones gaps to the previous
+// neighbor, which are positive since a row holds no repeated neighbor; the weight goes in the low bits of the code
+unsigned long long varint_graph::encode_row(const compressed_graph &graph, unsigned int vortex_index, unsigned char *bytes) const
+{
+	unsigned long long size = 0;
+	bool first = true;
+	unsigned int previous_neighbor = vortex_index;
+	graph.for_each_neighbor(vortex_index, [&](unsigned int neighbor, unsigned int edge_weight) {
+		unsigned long long code;
+		if (first)
+		{
+			long long difference = (long long)neighbor - (long long)vortex_index;
+			code = difference < 0 ? ((unsigned long long)(-difference) << 1) - 1 : (unsigned long long)difference << 1;
+			first = false;
+		}
+		else
+			code = neighbor - previous_neighbor;
+		previous_neighbor = neighbor;
+		if (this->weight_bits != SEPARATE_WEIGHTS)
+			code = code << this->weight_bits | (edge_weight - this->min_edge_weight);
+		size += write_varint(code, bytes == nullptr ? nullptr : bytes + size);
+		if (this->weight_bits == SEPARATE_WEIGHTS)
+			size += write_varint(edge_weight, bytes == nullptr ? nullptr : bytes + size);
+	});
+	return size;
+}
@@ -0,0 +1,190 @@
+#ifndef VARINT_GRAPH_H
+#define VARINT_GRAPH_H
+
+/**
+ * @file varint_graph.h
+ * @brief Read-only graph with gap encoded, variable length adjacency rows, for graphs whose CSR does not fit in memory.
+ *
+ * @author Fernando Elena Benavente
+ *
+ * The rows of a compressed_graph are sorted by neighbor index, so consecutive neighbors are usually close and their differences (gaps) small. A varint_graph stores every row as a byte stream of one varint per neighbor (7 bits per byte, the high bit set on every byte but the last): the first neighbor as the zigzag encoded difference to the vortex index (it can be lower), the next ones as the gap to the previous neighbor, shifted left by the bits of the weights, whose low bits hold the weight minus the lowest weight of the graph. With weights from 1 to 9 a gap under 16 and its weight take one byte, instead of the 4 + 4 bytes of the CSR; when every edge has the same weight (unweighted graphs) the weights take no bits at all. Weights spread over more than 31 bits would not fit next to the gap, they are then stored as a varint after it.
+ *
+ * Every row is preceded by its size in bytes as a varint, and a 64 bit byte offset is kept for every block of ROW_BLOCK_SIZE rows only: a row is found by jumping to the start of its block and skipping the rows before it by their sizes, one varint each, in bytes that are usually on the same cache lines. A full offset per vortex would cost 8 bytes per vortex, as much as the rows of a sparse graph; the block offsets and the row sizes cost about 1.5. Rows are then decoded on the fly by for_each_neighbor() and any_neighbor() without any buffer. Decoding a one byte varint is a compare and a branch, so the searches of graph_search.h run on it at a small cost over the CSR, reading a fraction of the memory.
+ *
+ * The gaps are small when neighbors have close indexes: a grid numbered row by row takes 2 bytes per neighbor and about a quarter of the memory of the CSR. On random and power law graphs the neighbors are scattered over the whole index range, the gaps take 2 to 3 bytes by themselves: Barabasi-Albert and G(n, p) graphs of 300000 vortexes and 8 to 10 neighbors per vortex take about 3 bytes per neighbor, 36% of the CSR. Byte aligned codes cannot do much better there, the gaps of random neighbors need about 16 bits: Stream-VByte (the 2 bit lengths of 4 codes packed in a control byte) took as many bytes as the varints, and packing the gaps of every row at the bits of its widest one saved 6 to 8% more, for a bit level decoding. A mesh whose indexes were shuffled can be renumbered first with reordered_graph (see reordered_graph.h) and its internal snapshot encoded; random graphs have no locality for a renumbering to find.
+ *
+ * The graph is built from a compressed_graph in two passes, sizing and writing, reading each row once per pass. A graph too big for memory as a CSR can be saved with compressed_graph::save(), mapped with compressed_graph::map_file() (the pages are read from the file as needed) and compressed from the mapping.
+ */
+
+#include "compressed_graph.h"
+#include "search_context.h"
+
+/**
+ * @class varint_graph
+ * @brief Undirected graph with varint gap encoded adjacency rows, queried with the templates of graph_search.h.
+ */
+class varint_graph
+{
+public:
+    static const unsigned int ROW_BLOCK_SHIFT = 4;                     /**< log2 of ROW_BLOCK_SIZE. */
+    static const unsigned int ROW_BLOCK_SIZE = 1u << ROW_BLOCK_SHIFT;  /**< Rows per block offset. */
+
+    /**
+     * @brief Encodes the rows of a compressed_graph, vortex indexes are kept.
+     *
+     * @param graph The snapshot to encode, only read.
+     */
+    varint_graph(const compressed_graph &graph);
+
+    /**
+     * @brief Destructor that frees the offsets and the row bytes.
+     */
+    ~varint_graph();
+
+    varint_graph(const varint_graph &) = delete;
+    varint_graph &operator=(const varint_graph &) = delete;
+
+    /**
+     * @brief Returns the size of the vortex index space (highest vortex index plus one).
+     */
+    unsigned int get_vortex_index_range() const;
+
+    /**
+     * @brief Returns the number of undirected edges.
+     */
+    unsigned long long get_edge_number() const;
+
+    /**
+     * @brief Returns the biggest edge weight.
+     */
+    unsigned int get_max_edge_weight() const;
+
+    /**
+     * @brief Returns the number of neighbors of a vortex, decoding its row, 0 if the index is out of range.
+     */
+    unsigned int get_degree(unsigned int vortex_index) const;
+
+    /**
+     * @brief Returns the bytes of the offsets and of the encoded rows.
+     */
+    unsigned long long get_memory_usage() const;
+
+    /**
+     * @brief Calls function(neighbor_index, edge_weight) for every neighbor of a vortex, decoding its row in index order.
+     *
+     * @param vortex_index The index of the vortex, must be lower than get_vortex_index_range().
+     * @param function Callable taking (unsigned int neighbor_index, unsigned int edge_weight).
+     */
+    template <class Function>
+    void for_each_neighbor(unsigned int vortex_index, Function function) const
+    {
+        any_neighbor(vortex_index, [&](unsigned int neighbor, unsigned int edge_weight) {
+            function(neighbor, edge_weight);
+            return false;
+        });
+    }
+
+    /**
+     * @brief Returns true if predicate(neighbor_index, edge_weight) is true for some neighbor of a vortex, stopping at the first one.
+     */
+    template <class Predicate>
+    bool any_neighbor(unsigned int vortex_index, Predicate predicate) const
+    {
+        const unsigned char *position = this->row_bytes + this->block_offsets[vortex_index >> ROW_BLOCK_SHIFT];
+        for (unsigned int k = vortex_index & (ROW_BLOCK_SIZE - 1); k > 0; --k)
+        {
+            unsigned long long skipped_size = read_varint(position); // the rows before it in the block
+            position += skipped_size;
+        }
+        unsigned long long row_size = read_varint(position);
+        const unsigned char *row_end = position + row_size;
+        if (position == row_end)
+            return false;
+        unsigned long long code = read_varint(position);
+        unsigned int edge_weight = split_weight(code, position);
+        unsigned int neighbor = vortex_index + (unsigned int)((code >> 1) ^ (0 - (code & 1))); // zigzag difference
+        while (true)
+        {
+            if (predicate(neighbor, edge_weight))
+                return true;
+            if (position == row_end)
+                return false;
+            code = read_varint(position);
+            edge_weight = split_weight(code, position);
+            neighbor += (unsigned int)code;
+        }
+    }
+
+    /**
+     * @brief Same as compressed_graph::search_shortest_path(), a quiet Dijkstra search on the buffers of a search_context.
+     */
+    int search_shortest_path(search_context &context, unsigned int base_vortex, unsigned int goal_vortex, unsigned int *path, unsigned int path_capacity, unsigned int &path_length) const;
+
+    /**
+     * @brief Same as compressed_graph::search_shortest_path_bidirectional(), a bidirectional Dijkstra search.
+     */
+    int search_shortest_path_bidirectional(search_context &forward_context, search_context &backward_context, unsigned int base_vortex, unsigned int goal_vortex, unsigned int *path, unsigned int path_capacity, unsigned int &path_length) const;
+
+    /**
+     * @brief Same as compressed_graph::search_all_distances(), parallel delta-stepping distances from a vortex.
+     */
+    int *search_all_distances(unsigned int base_vortex, unsigned int delta = 0, unsigned int thread_number = 1) const;
+
+    /**
+     * @brief Same as compressed_graph::get_reachable_bitset(), a direction-optimizing breadth first search.
+     */
+    unsigned long long *get_reachable_bitset(unsigned int base_vortex, unsigned int thread_number = 1) const;
+
+    /**
+     * @brief Same as compressed_graph::get_component_labels(), the lowest vortex index of the component of every vortex.
+     */
+    unsigned int *get_component_labels(unsigned int &component_number, unsigned int thread_number = 1) const;
+
+private:
+    unsigned int vortex_index_range;   /**< Highest vortex index plus one. */
+    unsigned long long edge_number;    /**< Undirected edges. */
+    unsigned int max_edge_weight;      /**< Biggest edge weight. */
+    unsigned int min_edge_weight;      /**< Lowest edge weight, the codes hold the weights minus it. */
+    unsigned int weight_bits;          /**< Low bits of every code holding the weight, 0 if every edge weighs the same, SEPARATE_WEIGHTS if the weights follow the codes. */
+    unsigned long long *block_offsets; /**< Byte offset in row_bytes of the first row of every block of ROW_BLOCK_SIZE rows. */
+    unsigned long long row_byte_number; /**< Size of row_bytes. */
+    unsigned char *row_bytes;          /**< Encoded rows one after another, each preceded by its size. */
+
+    /**
+     * @brief Decodes the varint at position and moves position past it.
+     */
+    static unsigned long long read_varint(const unsigned char *&position)
+    {
+        unsigned long long value = *position & 0x7F;
+        if (*position++ < 0x80)
+            return value;
+        for (unsigned int shift = 7;; shift += 7)
+        {
+            unsigned char byte = *position++;
+            value |= (unsigned long long)(byte & 0x7F) << shift;
+            if (byte < 0x80)
+                return value;
+        }
+    }
+
+    static const unsigned int SEPARATE_WEIGHTS = 32; /**< weight_bits of the weights too spread to share a 64 bit code with a gap. */
+
+    /**
+     * @brief Takes the weight out of the low bits of a code, or reads it after the code, and leaves the gap in code.
+     */
+    unsigned int split_weight(unsigned long long &code, const unsigned char *&position) const
+    {
+        if (this->weight_bits == SEPARATE_WEIGHTS)
+            return (unsigned int)read_varint(position);
+        unsigned int edge_weight = this->min_edge_weight + ((unsigned int)code & ((1u << this->weight_bits) - 1));
+        code >>= this->weight_bits;
+        return edge_weight;
+    }
+
+    /**
+     * @brief Encodes a row of the compressed_graph, or only measures it when bytes is nullptr, and returns its size.
+     */
+    unsigned long long encode_row(const compressed_graph &graph, unsigned int vortex_index, unsigned char *bytes) const;
+};
+
+#endif
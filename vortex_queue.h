@@ -0,0 +1,384 @@
+#ifndef VORTEX_QUEUE_H
+#define VORTEX_QUEUE_H
+
+/**
+ * @file vortex_queue.h
+ * @brief Indexed priority queues of vortexes used by the shortest path algorithms.
+ *
+ * @author Fernando Elena Benavente
+ *
+ * Both queues hold vortex indexes in the range [0, capacity) with a distance key, and support lowering the key of a vortex already queued, which is what Dijkstra's relaxation needs:
+ *
+ * - dary_heap: a d-ary min heap (4-ary by default) with a position table, O(log n) push, decrease and pop. Works for any key type.
+ * - bucket_queue: Dial's algorithm, a circular array of max_key_step + 1 buckets, O(1) push and decrease, pop amortized over the bucket scan. Only valid for integer keys when every pushed key lies in [last popped key, last popped key + max_key_step], which holds for Dijkstra with edge weights up to max_key_step. Suited to small integer weights such as the 1 to 9 weights of generate_random_edges().
+ *
+ * Queued vortexes are tracked individually, so clear() only costs the number of vortexes still queued (plus the bucket count for bucket_queue), not the capacity.
+ */
+
+#include <limits>
+
+/**
+ * @enum dijkstra_queue
+ * @brief Selects the priority queue used by the Dijkstra searches.
+ */
+enum dijkstra_queue
+{
+    DARY_HEAP_QUEUE, /**< 4-ary heap, valid for any weights. */
+    BUCKET_QUEUE     /**< Dial's bucket queue, for small integer weights. */
+};
+
+/**
+ * @class dary_heap
+ * @brief Indexed d-ary min heap of vortexes.
+ *
+ * @tparam Key Type of the distance keys.
+ * @tparam Arity Number of children of every heap node.
+ */
+template <typename Key, unsigned int Arity = 4>
+class dary_heap
+{
+public:
+    static const unsigned int NOT_QUEUED = std::numeric_limits<unsigned int>::max(); /**< Position of a vortex that is not in the heap. */
+
+    /**
+     * @brief Creates an empty heap for vortex indexes lower than capacity.
+     *
+     * @param capacity Size of the vortex index space.
+     */
+    dary_heap(unsigned int capacity)
+    {
+        this->capacity = capacity;
+        this->heap_size = 0;
+        this->heap_nodes = new unsigned int[capacity];
+        this->heap_keys = new Key[capacity];
+        this->position = new unsigned int[capacity];
+        for (unsigned int i = 0; i < capacity; ++i)
+            this->position[i] = NOT_QUEUED;
+    }
+
+    ~dary_heap()
+    {
+        delete[] this->heap_nodes;
+        delete[] this->heap_keys;
+        delete[] this->position;
+    }
+
+    dary_heap(const dary_heap &) = delete;
+    dary_heap &operator=(const dary_heap &) = delete;
+
+    /**
+     * @brief Returns true if the heap has no vortexes.
+     */
+    bool empty() const
+    {
+        return this->heap_size == 0;
+    }
+
+    /**
+     * @brief Returns the number of queued vortexes.
+     */
+    unsigned int size() const
+    {
+        return this->heap_size;
+    }
+
+    /**
+     * @brief Returns true if the vortex is currently queued.
+     */
+    bool contains(unsigned int vortex_index) const
+    {
+        return this->position[vortex_index] != NOT_QUEUED;
+    }
+
+    /**
+     * @brief Returns the smallest key in the heap, the heap must not be empty.
+     */
+    Key top_key() const
+    {
+        return this->heap_keys[0];
+    }
+
+    /**
+     * @brief Queues a vortex, or lowers its key if it is already queued with a bigger one.
+     *
+     * @param vortex_index The vortex to queue.
+     * @param key The distance key of the vortex.
+     */
+    void push(unsigned int vortex_index, Key key)
+    {
+        unsigned int slot = this->position[vortex_index];
+        if (slot == NOT_QUEUED)
+        {
+            slot = this->heap_size++;
+        }
+        else if (!(key < this->heap_keys[slot]))
+        {
+            return; // already queued with a smaller or equal key
+        }
+        sift_up(slot, vortex_index, key);
+    }
+
+    /**
+     * @brief Removes the vortex with the smallest key, the heap must not be empty.
+     *
+     * @param vortex_index Output, the vortex removed.
+     * @param key Output, its key.
+     */
+    void pop(unsigned int &vortex_index, Key &key)
+    {
+        vortex_index = this->heap_nodes[0];
+        key = this->heap_keys[0];
+        this->position[vortex_index] = NOT_QUEUED;
+
+        --this->heap_size;
+        if (this->heap_size > 0)
+            sift_down(0, this->heap_nodes[this->heap_size], this->heap_keys[this->heap_size]);
+    }
+
+    /**
+     * @brief Removes every queued vortex, in time proportional to the vortexes still queued.
+     */
+    void clear()
+    {
+        for (unsigned int i = 0; i < this->heap_size; ++i)
+            this->position[this->heap_nodes[i]] = NOT_QUEUED;
+        this->heap_size = 0;
+    }
+
+private:
+    unsigned int capacity;      /**< Size of the vortex index space. */
+    unsigned int heap_size;     /**< Number of queued vortexes. */
+    unsigned int *heap_nodes;   /**< Vortex stored in each heap slot. */
+    Key *heap_keys;             /**< Key of each heap slot, kept apart from the vortexes so comparisons stay in cache. */
+    unsigned int *position;     /**< Heap slot of every vortex, or NOT_QUEUED. */
+
+    // moves the hole at slot towards the root until the key fits, then stores the vortex there
+    void sift_up(unsigned int slot, unsigned int vortex_index, Key key)
+    {
+        while (slot > 0)
+        {
+            unsigned int parent = (slot - 1) / Arity;
+            if (!(key < this->heap_keys[parent]))
+                break;
+            this->heap_nodes[slot] = this->heap_nodes[parent];
+            this->heap_keys[slot] = this->heap_keys[parent];
+            this->position[this->heap_nodes[slot]] = slot;
+            slot = parent;
+        }
+        this->heap_nodes[slot] = vortex_index;
+        this->heap_keys[slot] = key;
+        this->position[vortex_index] = slot;
+    }
+
+    // moves the hole at slot towards the leaves until the key fits, then stores the vortex there
+    void sift_down(unsigned int slot, unsigned int vortex_index, Key key)
+    {
+        while (true)
+        {
+            unsigned int first_child = slot * Arity + 1;
+            if (first_child >= this->heap_size)
+                break;
+            unsigned int last_child = first_child + Arity < this->heap_size ? first_child + Arity : this->heap_size;
+            unsigned int best_child = first_child;
+            for (unsigned int child = first_child + 1; child < last_child; ++child)
+            {
+                if (this->heap_keys[child] < this->heap_keys[best_child])
+                    best_child = child;
+            }
+            if (!(this->heap_keys[best_child] < key))
+                break;
+            this->heap_nodes[slot] = this->heap_nodes[best_child];
+            this->heap_keys[slot] = this->heap_keys[best_child];
+            this->position[this->heap_nodes[slot]] = slot;
+            slot = best_child;
+        }
+        this->heap_nodes[slot] = vortex_index;
+        this->heap_keys[slot] = key;
+        this->position[vortex_index] = slot;
+    }
+};
+
+/**
+ * @class bucket_queue
+ * @brief Dial's bucket queue of vortexes for small non negative integer keys.
+ *
+ * Each bucket is a doubly linked list threaded through per vortex arrays, so pushing, lowering a key and removing a vortex are constant time.
+ *
+ * @tparam Key Integer type of the distance keys.
+ */
+template <typename Key>
+class bucket_queue
+{
+public:
+    static const unsigned int NO_VORTEX = std::numeric_limits<unsigned int>::max(); /**< End of a bucket list. */
+
+    /**
+     * @brief Creates an empty queue for vortex indexes lower than capacity.
+     *
+     * @param capacity Size of the vortex index space.
+     * @param max_key_step Largest difference between a pushed key and the last popped key (the maximum edge weight).
+     */
+    bucket_queue(unsigned int capacity, unsigned int max_key_step)
+    {
+        this->capacity = capacity;
+        this->bucket_number = max_key_step + 1;
+        this->queue_size = 0;
+        this->cursor_key = 0;
+        this->cursor_set = false;
+        this->bucket_head = new unsigned int[this->bucket_number];
+        this->next_node = new unsigned int[capacity];
+        this->previous_node = new unsigned int[capacity];
+        this->node_key = new Key[capacity];
+        this->queued = new bool[capacity]();
+        for (unsigned int i = 0; i < this->bucket_number; ++i)
+            this->bucket_head[i] = NO_VORTEX;
+    }
+
+    ~bucket_queue()
+    {
+        delete[] this->bucket_head;
+        delete[] this->next_node;
+        delete[] this->previous_node;
+        delete[] this->node_key;
+        delete[] this->queued;
+    }
+
+    bucket_queue(const bucket_queue &) = delete;
+    bucket_queue &operator=(const bucket_queue &) = delete;
+
+    /**
+     * @brief Returns true if the queue has no vortexes.
+     */
+    bool empty() const
+    {
+        return this->queue_size == 0;
+    }
+
+    /**
+     * @brief Returns the number of queued vortexes.
+     */
+    unsigned int size() const
+    {
+        return this->queue_size;
+    }
+
+    /**
+     * @brief Returns true if the vortex is currently queued.
+     */
+    bool contains(unsigned int vortex_index) const
+    {
+        return this->queued[vortex_index];
+    }
+
+    /**
+     * @brief Returns the smallest key in the queue, the queue must not be empty.
+     */
+    Key top_key()
+    {
+        advance_cursor();
+        return this->cursor_key;
+    }
+
+    /**
+     * @brief Queues a vortex, or lowers its key if it is already queued with a bigger one.
+     *
+     * The first push after construction or clear() sets the base key, later keys must not be lower than the last popped key and must stay within max_key_step of it.
+     *
+     * @param vortex_index The vortex to queue.
+     * @param key The distance key of the vortex.
+     */
+    void push(unsigned int vortex_index, Key key)
+    {
+        if (this->queued[vortex_index])
+        {
+            if (!(key < this->node_key[vortex_index]))
+                return;
+            unlink(vortex_index);
+        }
+        else
+        {
+            if (!this->cursor_set)
+            {
+                this->cursor_key = key;
+                this->cursor_set = true;
+            }
+            this->queued[vortex_index] = true;
+            ++this->queue_size;
+        }
+        this->node_key[vortex_index] = key;
+        link(vortex_index);
+    }
+
+    /**
+     * @brief Removes a vortex with the smallest key, the queue must not be empty.
+     *
+     * @param vortex_index Output, the vortex removed.
+     * @param key Output, its key.
+     */
+    void pop(unsigned int &vortex_index, Key &key)
+    {
+        advance_cursor();
+        vortex_index = this->bucket_head[this->cursor_key % this->bucket_number];
+        key = this->cursor_key;
+        unlink(vortex_index);
+        this->queued[vortex_index] = false;
+        --this->queue_size;
+    }
+
+    /**
+     * @brief Removes every queued vortex, in time proportional to the buckets plus the vortexes still queued.
+     */
+    void clear()
+    {
+        for (unsigned int i = 0; i < this->bucket_number; ++i)
+        {
+            for (unsigned int node = this->bucket_head[i]; node != NO_VORTEX; node = this->next_node[node])
+                this->queued[node] = false;
+            this->bucket_head[i] = NO_VORTEX;
+        }
+        this->queue_size = 0;
+        this->cursor_set = false;
+    }
+
+private:
+    unsigned int capacity;        /**< Size of the vortex index space. */
+    unsigned int bucket_number;   /**< Number of buckets in the circular array. */
+    unsigned int queue_size;      /**< Number of queued vortexes. */
+    Key cursor_key;               /**< Key of the bucket where the next minimum is searched. */
+    bool cursor_set;              /**< False until the first push after construction or clear(). */
+    unsigned int *bucket_head;    /**< First vortex of every bucket, or NO_VORTEX. */
+    unsigned int *next_node;      /**< Next vortex in the same bucket. */
+    unsigned int *previous_node;  /**< Previous vortex in the same bucket, or NO_VORTEX for the first one. */
+    Key *node_key;                /**< Key of every queued vortex. */
+    bool *queued;                 /**< Whether every vortex is queued. */
+
+    // skips empty buckets until the cursor points to the bucket of the smallest key
+    void advance_cursor()
+    {
+        while (this->bucket_head[this->cursor_key % this->bucket_number] == NO_VORTEX)
+            ++this->cursor_key;
+    }
+
+    void link(unsigned int vortex_index)
+    {
+        unsigned int bucket = this->node_key[vortex_index] % this->bucket_number;
+        this->previous_node[vortex_index] = NO_VORTEX;
+        this->next_node[vortex_index] = this->bucket_head[bucket];
+        if (this->bucket_head[bucket] != NO_VORTEX)
+            this->previous_node[this->bucket_head[bucket]] = vortex_index;
+        this->bucket_head[bucket] = vortex_index;
+    }
+
+    void unlink(unsigned int vortex_index)
+    {
+        unsigned int bucket = this->node_key[vortex_index] % this->bucket_number;
+        if (this->previous_node[vortex_index] == NO_VORTEX)
+            this->bucket_head[bucket] = this->next_node[vortex_index];
+        else
+            this->next_node[this->previous_node[vortex_index]] = this->next_node[vortex_index];
+        if (this->next_node[vortex_index] != NO_VORTEX)
+            this->previous_node[this->next_node[vortex_index]] = this->previous_node[vortex_index];
+    }
+};
+
+#endif